@@ -0,0 +1,65 @@
+/*
+ * Synthetic cursor backend for the benchmarks: replaces zoom-cursor.c so the
+ * sampler thread runs without any windowing system. The cursor moves on a
+ * circle across a 1920x1080 desktop.
+ */
+#include "zoom-cursor.h"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <math.h>
+
+bool cursor_backend_acquire(void)
+{
+    return true;
+}
+
+void cursor_backend_release(void)
+{
+}
+
+void cursor_backend_shutdown(void)
+{
+}
+
+bool cursor_backend_query(float *x, float *y)
+{
+    double t = (double)os_gettime_ns() / 1000000000.0;
+
+    *x = (float)(960.0 + 600.0 * cos(t * 2.0));
+    *y = (float)(540.0 + 400.0 * sin(t * 2.0));
+    return true;
+}
+
+bool cursor_backend_has_events(void)
+{
+    return false;
+}
+
+bool cursor_backend_wait_motion(uint64_t timeout_ns)
+{
+    UNUSED_PARAMETER(timeout_ns);
+    return false;
+}
+
+int cursor_backend_get_monitors(struct cursor_monitor *monitors, int max)
+{
+    if (max < 1)
+        return 0;
+
+    monitors[0].x = 0;
+    monitors[0].y = 0;
+    monitors[0].width = 1920;
+    monitors[0].height = 1080;
+    return 1;
+}
+
+bool cursor_backend_monitors_changed(void)
+{
+    return false;
+}
+
+bool cursor_backend_take_gesture(struct cursor_gesture *gesture)
+{
+    UNUSED_PARAMETER(gesture);
+    return false;
+}
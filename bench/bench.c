@@ -0,0 +1,265 @@
+/*
+ * Headless microbenchmarks for the per-frame zoom hot paths.
+ *
+ * Every case advances a simulated 60 fps frame clock and reports one JSON
+ * object per line:
+ *   {"bench": ..., "variant": ..., "frames": N, "ns_per_frame": x, "allocs_per_frame": y}
+ * Allocations are counted through the libobs allocator (bmalloc/bzalloc),
+ * which is the only allocator the plugin uses.
+ *
+ * Usage: zoom-bench [frames]   (default 5000000)
+ */
+#include <obs-module.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "zoom-motion.h"
+#include "zoom-smoothing.h"
+#include "zoom-tracking.h"
+#include "zoom-sampler.h"
+
+#define FRAME_NS 16666667ULL
+#define RETARGET_INTERVAL 30
+
+// 防止编译器把被测调用优化掉
+static volatile float sink;
+
+struct bench_result {
+    uint64_t elapsed;
+    long allocs;
+};
+
+static void report(const char *bench, const char *variant, uint64_t frames,
+                   const struct bench_result *result)
+{
+    printf("{\"bench\": \"%s\", \"variant\": \"%s\", \"frames\": %llu, "
+           "\"ns_per_frame\": %.2f, \"allocs_per_frame\": %.4f}\n",
+           bench, variant, (unsigned long long)frames,
+           (double)result->elapsed / (double)frames,
+           (double)result->allocs / (double)frames);
+    fflush(stdout);
+}
+
+static void bench_begin(struct bench_result *result)
+{
+    result->allocs = os_atomic_load_long(&obs_stub_alloc_count);
+    result->elapsed = os_gettime_ns();
+}
+
+static void bench_end(struct bench_result *result)
+{
+    result->elapsed = os_gettime_ns() - result->elapsed;
+    result->allocs = os_atomic_load_long(&obs_stub_alloc_count) - result->allocs;
+}
+
+static const char *smooth_mode_name(int mode)
+{
+    switch (mode) {
+        case SMOOTH_MODE_LINEAR: return "linear";
+        case SMOOTH_MODE_EXPONENTIAL: return "exponential";
+        case SMOOTH_MODE_LOGARITHMIC: return "logarithmic";
+        case SMOOTH_MODE_SPRING: return "spring";
+        default: return "unknown";
+    }
+}
+
+// smoothing_update：每30帧改变一次目标，覆盖过渡中和静止两种状态
+static void bench_smoothing_update(uint64_t frames, int mode)
+{
+    struct smoothing_data smoothing;
+    struct bench_result result;
+    uint64_t now = FRAME_NS;
+
+    smoothing_init(&smoothing);
+    smoothing.mode = mode;
+    smoothing_rebuild_curve(&smoothing);
+
+    bench_begin(&result);
+    for (uint64_t i = 0; i < frames; i++) {
+        now += FRAME_NS;
+        if (i % RETARGET_INTERVAL == 0)
+            smoothing_set_target(&smoothing, (i / RETARGET_INTERVAL) & 1 ? 1.0f : 3.0f, now);
+        sink = smoothing_update(&smoothing, now);
+    }
+    bench_end(&result);
+
+    report("smoothing_update", smooth_mode_name(mode), frames, &result);
+}
+
+// 曲线求值：动画时长足够长，每一帧都落在过渡中间（calculate_smoothed_scale）
+static void bench_smoothed_scale(uint64_t frames, int mode)
+{
+    struct smoothing_data smoothing;
+    struct bench_result result;
+    uint64_t now = FRAME_NS;
+
+    smoothing_init(&smoothing);
+    smoothing.mode = mode;
+    smoothing.animation_time = frames * FRAME_NS * 2;
+    smoothing_rebuild_curve(&smoothing);
+    smoothing_set_target(&smoothing, 4.0f, now);
+
+    bench_begin(&result);
+    for (uint64_t i = 0; i < frames; i++) {
+        now += FRAME_NS;
+        sink = smoothing_update(&smoothing, now);
+    }
+    bench_end(&result);
+
+    report("calculate_smoothed_scale", smooth_mode_name(mode), frames, &result);
+}
+
+// 参数变化时重建曲线表（每次迭代修改一个参数以强制重建）
+static void bench_rebuild_curve(uint64_t frames, int mode)
+{
+    struct smoothing_data smoothing;
+    struct bench_result result;
+
+    smoothing_init(&smoothing);
+    smoothing.mode = mode;
+
+    bench_begin(&result);
+    for (uint64_t i = 0; i < frames; i++) {
+        smoothing.overshoot = (i & 1) ? 0.1f : 0.0f;
+        smoothing_rebuild_curve(&smoothing);
+    }
+    bench_end(&result);
+    sink = smoothing.curve_error;
+
+    report("smoothing_rebuild_curve", smooth_mode_name(mode), frames, &result);
+}
+
+static const char *tracking_variant(int mode, int predict_mode)
+{
+    static const char *names[3][3] = {
+        {"disabled", "disabled+velocity", "disabled+kalman"},
+        {"realtime", "realtime+velocity", "realtime+kalman"},
+        {"zooming", "zooming+velocity", "zooming+kalman"},
+    };
+    return names[mode][predict_mode];
+}
+
+// tracking_update_mouse：帧时间跟随真实时间，读取的是采样线程实时写入的环形缓冲区
+static void bench_tracking_update(uint64_t frames, int mode, int predict_mode)
+{
+    struct tracking_data tracking;
+    struct bench_result result;
+    uint64_t now = os_gettime_ns();
+
+    tracking_init(&tracking, &cursor_sampler_source);
+    tracking_set_mode(&tracking, mode);
+    tracking_set_prediction(&tracking, predict_mode, 16);
+
+    bench_begin(&result);
+    for (uint64_t i = 0; i < frames; i++) {
+        float scale = 1.0f + (float)(i % 60) * 0.05f;
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, scale, scale - 0.05f, now);
+    }
+    bench_end(&result);
+    sink = tracking.mouse_x;
+
+    report("tracking_update_mouse", tracking_variant(mode, predict_mode), frames, &result);
+    tracking_free(&tracking);
+}
+
+static void bench_tracking_center(uint64_t frames, int mode, bool latched)
+{
+    struct tracking_data tracking;
+    struct bench_result result;
+    uint64_t now = os_gettime_ns();
+    float cx = 0.0f, cy = 0.0f;
+
+    tracking_init(&tracking, &cursor_sampler_source);
+    tracking_set_mode(&tracking, mode);
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 1.0f, now);
+
+    bench_begin(&result);
+    for (uint64_t i = 0; i < frames; i++) {
+        if (latched)
+            tracking_get_latched_center(&tracking, 1920.0f, 1080.0f, now + i, &cx, &cy);
+        else
+            tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+        sink = cx + cy;
+    }
+    bench_end(&result);
+
+    report(latched ? "tracking_get_latched_center" : "tracking_get_center",
+           tracking_variant(mode, PREDICT_MODE_NONE), frames, &result);
+    tracking_free(&tracking);
+}
+
+static const char *motion_kernel_name(int kernel)
+{
+    switch (kernel) {
+        case MOTION_KERNEL_SSE2: return "sse2";
+        case MOTION_KERNEL_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+// 自动取景每次读回的分析：1920x1080缩小8倍后的两帧，16x9分块
+static void bench_motion_energy(uint64_t frames, int kernel)
+{
+    enum { W = 240, H = 135, COLS = 16, ROWS = 9 };
+    uint8_t *current = bmalloc(W * H * 4);
+    uint8_t *previous = bmalloc(W * H * 4);
+    uint64_t energy[COLS * ROWS];
+    struct bench_result result;
+    float fx = 0.0f, fy = 0.0f;
+
+    for (size_t i = 0; i < W * H * 4; i++) {
+        current[i] = (uint8_t)(i * 7);
+        previous[i] = (uint8_t)(i * 7 + (i % 97 == 0 ? 50 : 0));
+    }
+
+    bench_begin(&result);
+    for (uint64_t i = 0; i < frames; i++) {
+        motion_tile_energy(kernel, current, previous, W, H, W * 4, COLS, ROWS, energy);
+        motion_find_focus(energy, COLS, ROWS, 1, &fx, &fy);
+        sink = fx + fy;
+    }
+    bench_end(&result);
+
+    report("motion_tile_energy", motion_kernel_name(kernel), frames, &result);
+    bfree(current);
+    bfree(previous);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t frames = 5000000;
+
+    if (argc > 1)
+        frames = strtoull(argv[1], NULL, 10);
+    if (!frames)
+        frames = 1;
+
+    for (int mode = SMOOTH_MODE_LINEAR; mode <= SMOOTH_MODE_SPRING; mode++)
+        bench_smoothing_update(frames, mode);
+    for (int mode = SMOOTH_MODE_LINEAR; mode <= SMOOTH_MODE_LOGARITHMIC; mode++)
+        bench_smoothed_scale(frames, mode);
+    for (int mode = SMOOTH_MODE_LINEAR; mode <= SMOOTH_MODE_LOGARITHMIC; mode++)
+        bench_rebuild_curve(frames / 1000 + 1, mode);
+    for (int kernel = MOTION_KERNEL_SCALAR; kernel <= MOTION_KERNEL_AVX2; kernel++) {
+        if (motion_kernel_supported(kernel))
+            bench_motion_energy(frames / 1000 + 1, kernel);
+    }
+
+    // 让采样线程先写入一些数据
+    cursor_sampler_acquire();
+    os_sleepto_ns(os_gettime_ns() + 50000000ULL);
+
+    for (int mode = TRACKING_MODE_DISABLED; mode <= TRACKING_MODE_ZOOMING; mode++) {
+        for (int predict = PREDICT_MODE_NONE; predict <= PREDICT_MODE_KALMAN; predict++)
+            bench_tracking_update(frames, mode, predict);
+    }
+    for (int mode = TRACKING_MODE_DISABLED; mode <= TRACKING_MODE_ZOOMING; mode++) {
+        bench_tracking_center(frames, mode, false);
+        bench_tracking_center(frames, mode, true);
+    }
+
+    cursor_sampler_release();
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * Minimal libobs stand-in for the headless benchmarks.
+ *
+ * Only the declarations used by the sampler and mapping modules are
+ * provided; zoom-core itself does not depend on libobs. Source/settings
+ * queries return nothing, so the mapping layer falls back to plain
+ * source-size mapping.
+ */
+#ifndef OBS_STUB_MODULE_H
+#define OBS_STUB_MODULE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define UNUSED_PARAMETER(param) (void)param
+
+enum {
+    LOG_ERROR = 100,
+    LOG_WARNING = 200,
+    LOG_INFO = 300,
+    LOG_DEBUG = 400,
+};
+
+typedef struct obs_source obs_source_t;
+typedef struct obs_data obs_data_t;
+
+void blog(int log_level, const char *format, ...);
+
+void *bmalloc(size_t size);
+void *bzalloc(size_t size);
+void bfree(void *ptr);
+
+const char *obs_source_get_unversioned_id(const obs_source_t *source);
+obs_data_t *obs_source_get_settings(const obs_source_t *source);
+long long obs_data_get_int(obs_data_t *data, const char *name);
+void obs_data_release(obs_data_t *data);
+uint64_t obs_get_video_frame_time(void);
+
+// 统计通过libobs分配器进行的分配次数
+extern volatile long obs_stub_alloc_count;
+
+#endif
@@ -0,0 +1,168 @@
+#define _GNU_SOURCE
+#include <obs-module.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+volatile long obs_stub_alloc_count = 0;
+
+void blog(int log_level, const char *format, ...)
+{
+    va_list args;
+
+    // 基准测试只输出警告和错误，避免日志干扰计时
+    if (log_level > LOG_WARNING)
+        return;
+
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+void *bmalloc(size_t size)
+{
+    os_atomic_inc_long(&obs_stub_alloc_count);
+    return malloc(size ? size : 1);
+}
+
+void *bzalloc(size_t size)
+{
+    os_atomic_inc_long(&obs_stub_alloc_count);
+    return calloc(1, size ? size : 1);
+}
+
+void bfree(void *ptr)
+{
+    free(ptr);
+}
+
+const char *obs_source_get_unversioned_id(const obs_source_t *source)
+{
+    UNUSED_PARAMETER(source);
+    return NULL;
+}
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source)
+{
+    UNUSED_PARAMETER(source);
+    return NULL;
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+    UNUSED_PARAMETER(data);
+    UNUSED_PARAMETER(name);
+    return 0;
+}
+
+void obs_data_release(obs_data_t *data)
+{
+    UNUSED_PARAMETER(data);
+}
+
+uint64_t obs_get_video_frame_time(void)
+{
+    return os_gettime_ns();
+}
+
+uint64_t os_gettime_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+bool os_sleepto_ns(uint64_t time_target)
+{
+    uint64_t now = os_gettime_ns();
+    if (time_target <= now)
+        return false;
+
+    struct timespec ts;
+    ts.tv_sec = (time_t)((time_target - now) / 1000000000ULL);
+    ts.tv_nsec = (long)((time_target - now) % 1000000000ULL);
+    nanosleep(&ts, NULL);
+    return true;
+}
+
+void os_set_thread_name(const char *name)
+{
+    pthread_setname_np(pthread_self(), name);
+}
+
+void *os_dlopen(const char *path)
+{
+    UNUSED_PARAMETER(path);
+    return NULL;
+}
+
+void *os_dlsym(void *module, const char *func)
+{
+    UNUSED_PARAMETER(module);
+    UNUSED_PARAMETER(func);
+    return NULL;
+}
+
+void os_dlclose(void *module)
+{
+    UNUSED_PARAMETER(module);
+}
+
+struct os_event_data {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool signalled;
+    bool manual;
+};
+
+int os_event_init(os_event_t **event, enum os_event_type type)
+{
+    struct os_event_data *data = calloc(1, sizeof(*data));
+    if (!data)
+        return -1;
+
+    pthread_mutex_init(&data->mutex, NULL);
+    pthread_cond_init(&data->cond, NULL);
+    data->manual = type == OS_EVENT_TYPE_MANUAL;
+    *event = data;
+    return 0;
+}
+
+void os_event_destroy(os_event_t *event)
+{
+    if (!event)
+        return;
+
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+    free(event);
+}
+
+int os_event_signal(os_event_t *event)
+{
+    pthread_mutex_lock(&event->mutex);
+    event->signalled = true;
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+    return 0;
+}
+
+int os_event_try(os_event_t *event)
+{
+    int ret = EAGAIN;
+
+    pthread_mutex_lock(&event->mutex);
+    if (event->signalled) {
+        if (!event->manual)
+            event->signalled = false;
+        ret = 0;
+    }
+    pthread_mutex_unlock(&event->mutex);
+    return ret;
+}
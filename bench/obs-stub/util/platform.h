@@ -0,0 +1,15 @@
+#ifndef OBS_STUB_PLATFORM_H
+#define OBS_STUB_PLATFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+uint64_t os_gettime_ns(void);
+bool os_sleepto_ns(uint64_t time_target);
+void os_set_thread_name(const char *name);
+
+void *os_dlopen(const char *path);
+void *os_dlsym(void *module, const char *func);
+void os_dlclose(void *module);
+
+#endif
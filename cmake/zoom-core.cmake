@@ -0,0 +1,28 @@
+# zoom-core: libobs-independent zoom math (smoothing, tracking, viewport, motion,
+# trajectory log replay, scripted timelines).
+#
+# Included by the plugin, the tests and the benchmarks. Clock and cursor input
+# are injected by the caller, so the library has no platform dependencies.
+include_guard(GLOBAL)
+
+set(ZOOM_CORE_SRC_DIR "${CMAKE_CURRENT_LIST_DIR}/../src")
+
+add_library(zoom-core STATIC)
+
+target_sources(
+  zoom-core
+  PRIVATE
+    ${ZOOM_CORE_SRC_DIR}/zoom-motion.c
+    ${ZOOM_CORE_SRC_DIR}/zoom-replay.c
+    ${ZOOM_CORE_SRC_DIR}/zoom-smoothing.c
+    ${ZOOM_CORE_SRC_DIR}/zoom-timeline.c
+    ${ZOOM_CORE_SRC_DIR}/zoom-tracking.c
+    ${ZOOM_CORE_SRC_DIR}/zoom-transform.c
+)
+
+target_include_directories(zoom-core PUBLIC "${ZOOM_CORE_SRC_DIR}")
+set_target_properties(zoom-core PROPERTIES POSITION_INDEPENDENT_CODE ON)
+
+if(NOT MSVC)
+  target_link_libraries(zoom-core PUBLIC m)
+endif()
@@ -20,6 +20,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include <plugin-support.h>
 #include "zoom-filter.h"
 #include "zoom-filter-ui.h"
+#include "zoom-cursor.h"
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "zh-CN")
@@ -33,5 +34,6 @@ bool obs_module_load(void)
 
 void obs_module_unload(void)
 {
+    cursor_backend_shutdown();
     obs_log(LOG_INFO, "Zoom filter unloaded");
 }
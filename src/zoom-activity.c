@@ -0,0 +1,264 @@
+#include "zoom-activity.h"
+#include "zoom-motion.h"
+#include <graphics/vec4.h>
+#include <util/platform.h>
+#include <math.h>
+#include <string.h>
+
+// 分块平均每像素的绝对差之和（RGBA四个通道合计）低于此值时视为噪声（编码噪点、光标闪烁）
+#define ACTIVITY_MIN_ENERGY_PER_PIXEL 2
+
+// 焦点坐标打包在一个long中（x在高16位，y在低16位，单位万分之一），读取方不会读到撕裂的值
+#define FOCUS_SCALE 10000.0f
+
+static const char *kernel_name(int kernel)
+{
+    switch (kernel) {
+        case MOTION_KERNEL_AVX2: return "AVX2";
+        case MOTION_KERNEL_SSE2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+static void swap_frames(struct activity_frame *a, struct activity_frame *b)
+{
+    struct activity_frame tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// 比较相邻两帧，发布最活跃区域的中心（仅工作线程调用）
+static void process_frame(struct activity_data *activity)
+{
+    struct activity_frame *current = &activity->current;
+    struct activity_frame *previous = &activity->previous;
+    uint64_t energy[ACTIVITY_TILE_COLS * ACTIVITY_TILE_ROWS];
+    float x, y;
+
+    if (previous->data && previous->width == current->width &&
+        previous->height == current->height) {
+        motion_tile_energy(activity->kernel, current->data, previous->data,
+                           current->width, current->height, current->width * 4,
+                           ACTIVITY_TILE_COLS, ACTIVITY_TILE_ROWS, energy);
+
+        uint64_t tile_pixels = (uint64_t)current->width * current->height /
+                               (ACTIVITY_TILE_COLS * ACTIVITY_TILE_ROWS);
+        uint64_t threshold = tile_pixels * ACTIVITY_MIN_ENERGY_PER_PIXEL + 1;
+
+        if (motion_find_focus(energy, ACTIVITY_TILE_COLS, ACTIVITY_TILE_ROWS, threshold, &x, &y)) {
+            long packed = (lroundf(x * FOCUS_SCALE) << 16) | lroundf(y * FOCUS_SCALE);
+            os_atomic_set_long(&activity->focus, packed);
+            os_atomic_inc_long(&activity->focus_generation);
+        }
+    }
+
+    // 本帧成为下一次比较的基准，旧缓冲区留给下一次交换
+    swap_frames(current, previous);
+}
+
+static void *activity_thread(void *param)
+{
+    struct activity_data *activity = param;
+
+    os_set_thread_name("zoom-filter: activity");
+
+    while (os_event_wait(activity->event) == 0 && !os_atomic_load_bool(&activity->stop)) {
+        bool ready;
+
+        // 只在锁内交换缓冲区指针，渲染线程不会因计算而等待
+        pthread_mutex_lock(&activity->mutex);
+        ready = activity->incoming_ready;
+        if (ready) {
+            swap_frames(&activity->incoming, &activity->current);
+            activity->incoming_ready = false;
+        }
+        pthread_mutex_unlock(&activity->mutex);
+
+        if (ready)
+            process_frame(activity);
+    }
+
+    return NULL;
+}
+
+bool activity_init(struct activity_data *activity)
+{
+    memset(activity, 0, sizeof(*activity));
+    activity->interval = 100000000ULL;  // 100ms
+    activity->downscale = 8;
+    activity->focus = (5000L << 16) | 5000L;
+
+    if (pthread_mutex_init(&activity->mutex, NULL) != 0)
+        return false;
+    if (os_event_init(&activity->event, OS_EVENT_TYPE_AUTO) != 0) {
+        pthread_mutex_destroy(&activity->mutex);
+        return false;
+    }
+    return true;
+}
+
+static void destroy_surfaces(struct activity_data *activity)
+{
+    for (int i = 0; i < ACTIVITY_STAGE_COUNT; i++) {
+        gs_stagesurface_destroy(activity->stagesurf[i]);
+        activity->stagesurf[i] = NULL;
+        activity->staged[i] = false;
+    }
+    activity->stage_width = 0;
+    activity->stage_height = 0;
+}
+
+void activity_free(struct activity_data *activity)
+{
+    activity_set_enabled(activity, false);
+
+    obs_enter_graphics();
+    destroy_surfaces(activity);
+    gs_texrender_destroy(activity->texrender);
+    activity->texrender = NULL;
+    obs_leave_graphics();
+
+    bfree(activity->incoming.data);
+    bfree(activity->current.data);
+    bfree(activity->previous.data);
+
+    // 初始化失败时event为NULL，互斥量也未创建
+    if (activity->event) {
+        os_event_destroy(activity->event);
+        pthread_mutex_destroy(&activity->mutex);
+    }
+}
+
+void activity_set_enabled(struct activity_data *activity, bool enabled)
+{
+    if (!activity->event || enabled == os_atomic_load_bool(&activity->running))
+        return;
+
+    if (enabled) {
+        // 重新启用时不与停用前的旧画面比较
+        pthread_mutex_lock(&activity->mutex);
+        activity->incoming_ready = false;
+        pthread_mutex_unlock(&activity->mutex);
+        activity->previous.width = 0;
+        activity->previous.height = 0;
+        activity->kernel = motion_best_kernel();
+        os_atomic_set_bool(&activity->stop, false);
+
+        if (pthread_create(&activity->thread, NULL, activity_thread, activity) != 0) {
+            blog(LOG_ERROR, "[zoom-activity] failed to start activity thread");
+            return;
+        }
+        os_atomic_set_bool(&activity->running, true);
+        blog(LOG_INFO, "[zoom-activity] auto-framing started (%s motion kernel)",
+             kernel_name(activity->kernel));
+    } else {
+        os_atomic_set_bool(&activity->stop, true);
+        os_event_signal(activity->event);
+        pthread_join(activity->thread, NULL);
+        os_atomic_set_bool(&activity->running, false);
+    }
+}
+
+// 把映射出的画面复制给工作线程（按行复制，去掉读回表面的行对齐）
+static void hand_off(struct activity_data *activity, const uint8_t *data, uint32_t linesize,
+                     uint32_t width, uint32_t height)
+{
+    size_t row = (size_t)width * 4;
+    size_t size = row * height;
+
+    pthread_mutex_lock(&activity->mutex);
+    if (activity->incoming.capacity < size) {
+        activity->incoming.data = brealloc(activity->incoming.data, size);
+        activity->incoming.capacity = size;
+    }
+    for (uint32_t y = 0; y < height; y++)
+        memcpy(activity->incoming.data + row * y, data + (size_t)linesize * y, row);
+    activity->incoming.width = width;
+    activity->incoming.height = height;
+    activity->incoming_ready = true;
+    pthread_mutex_unlock(&activity->mutex);
+
+    os_event_signal(activity->event);
+}
+
+void activity_capture(struct activity_data *activity, obs_source_t *target,
+                      uint32_t width, uint32_t height, uint64_t frame_time)
+{
+    if (!os_atomic_load_bool(&activity->running) || !width || !height)
+        return;
+    if (activity->last_capture && frame_time - activity->last_capture < activity->interval)
+        return;
+    activity->last_capture = frame_time;
+
+    uint32_t downscale = activity->downscale ? activity->downscale : 1;
+    uint32_t cw = width / downscale ? width / downscale : 1;
+    uint32_t ch = height / downscale ? height / downscale : 1;
+
+    if (cw != activity->stage_width || ch != activity->stage_height) {
+        destroy_surfaces(activity);
+        for (int i = 0; i < ACTIVITY_STAGE_COUNT; i++) {
+            activity->stagesurf[i] = gs_stagesurface_create(cw, ch, GS_RGBA);
+            if (!activity->stagesurf[i]) {
+                destroy_surfaces(activity);
+                return;
+            }
+        }
+        activity->stage_width = cw;
+        activity->stage_height = ch;
+        activity->stage_index = 0;
+    }
+
+    if (!activity->texrender) {
+        activity->texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!activity->texrender)
+            return;
+    }
+
+    // 缩小渲染目标源（未缩放的原始画面），并发起异步复制
+    int index = activity->stage_index;
+    gs_texrender_reset(activity->texrender);
+    if (gs_texrender_begin(activity->texrender, cw, ch)) {
+        struct vec4 clear_color;
+        vec4_zero(&clear_color);
+        gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+        gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+
+        gs_blend_state_push();
+        gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+        obs_source_video_render(target);
+        gs_blend_state_pop();
+        gs_texrender_end(activity->texrender);
+
+        gs_stage_texture(activity->stagesurf[index],
+                         gs_texrender_get_texture(activity->texrender));
+        activity->staged[index] = true;
+    }
+
+    // 取回上一次复制的表面：已经过了一个读回间隔，映射不会等待GPU
+    int ready = (index + 1) % ACTIVITY_STAGE_COUNT;
+    if (activity->staged[ready]) {
+        uint8_t *data;
+        uint32_t linesize;
+
+        if (gs_stagesurface_map(activity->stagesurf[ready], &data, &linesize)) {
+            hand_off(activity, data, linesize, cw, ch);
+            gs_stagesurface_unmap(activity->stagesurf[ready]);
+        }
+        activity->staged[ready] = false;
+    }
+    activity->stage_index = ready;
+}
+
+bool activity_get_focus(struct activity_data *activity, float *x, float *y)
+{
+    long generation = os_atomic_load_long(&activity->focus_generation);
+
+    if (generation == activity->focus_seen)
+        return false;
+    activity->focus_seen = generation;
+
+    long packed = os_atomic_load_long(&activity->focus);
+    *x = (float)((packed >> 16) & 0xffff) / FOCUS_SCALE;
+    *y = (float)(packed & 0xffff) / FOCUS_SCALE;
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef ZOOM_ACTIVITY_H
+#define ZOOM_ACTIVITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <obs-module.h>
+#include <util/threading.h>
+
+// 运动能量网格（分块数）
+#define ACTIVITY_TILE_COLS 16
+#define ACTIVITY_TILE_ROWS 9
+
+// 读回缓冲数：本次复制到一个表面，同时映射上一次复制的表面，GPU早已完成，不会等待
+#define ACTIVITY_STAGE_COUNT 2
+
+// 一帧缩小后的画面（RGBA，像素紧密排列）
+struct activity_frame {
+    uint8_t *data;
+    size_t capacity;
+    uint32_t width;
+    uint32_t height;
+};
+
+// 画面活动检测：渲染线程定期把目标源缩小渲染并异步读回，工作线程计算分块运动能量，
+// 把最活跃区域的中心作为自动取景的焦点
+struct activity_data {
+    // 参数（设置更新时写入）
+    uint64_t interval;      // 读回间隔(ns)
+    uint32_t downscale;     // 缩小倍数
+
+    // 图形资源（仅渲染线程访问）
+    gs_texrender_t *texrender;
+    gs_stagesurf_t *stagesurf[ACTIVITY_STAGE_COUNT];
+    bool staged[ACTIVITY_STAGE_COUNT];
+    int stage_index;        // 下一次复制使用的表面
+    uint32_t stage_width;
+    uint32_t stage_height;
+    uint64_t last_capture;
+
+    // 渲染线程交给工作线程的最新一帧
+    pthread_mutex_t mutex;
+    struct activity_frame incoming;
+    bool incoming_ready;
+
+    // 工作线程
+    pthread_t thread;
+    os_event_t *event;
+    volatile bool stop;
+    volatile bool running;  // 工作线程是否在运行（渲染线程据此决定是否读回）
+    struct activity_frame current;  // 工作线程私有
+    struct activity_frame previous;
+    int kernel;
+
+    // 焦点（工作线程写入、滤镜随时读取）
+    volatile long focus;            // x、y打包（各占16位，单位万分之一）
+    volatile long focus_generation; // 每次得到新焦点时递增
+    long focus_seen;                // 读取方已处理的代号
+};
+
+// 初始化/释放（释放时会停止工作线程并销毁图形资源）
+bool activity_init(struct activity_data *activity);
+void activity_free(struct activity_data *activity);
+
+// 启动/停止工作线程（非渲染线程调用）
+void activity_set_enabled(struct activity_data *activity, bool enabled);
+
+// 渲染线程调用：到达读回间隔时缩小渲染目标源并复制到读回表面，同时取回上一次的结果
+void activity_capture(struct activity_data *activity, obs_source_t *target,
+                      uint32_t width, uint32_t height, uint64_t frame_time);
+
+// 读取新的焦点（0-1范围），自上次读取以来没有新焦点时返回false
+bool activity_get_focus(struct activity_data *activity, float *x, float *y);
+
+#endif // ZOOM_ACTIVITY_H
@@ -0,0 +1,59 @@
+#include "zoom-command.h"
+#include <obs-module.h>
+#include <util/threading.h>
+
+void command_queue_init(struct command_queue *queue)
+{
+    for (long i = 0; i < COMMAND_QUEUE_SIZE; i++)
+        queue->slots[i].sequence = i;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+bool command_queue_push(struct command_queue *queue, const struct zoom_command *command)
+{
+    unsigned long head = (unsigned long)os_atomic_load_long(&queue->head);
+    struct command_slot *slot;
+
+    // 槽位空闲时抢占写入位置，被其他生产者抢先时从新的位置重试
+    for (;;) {
+        slot = &queue->slots[head & COMMAND_QUEUE_MASK];
+        long diff = (long)((unsigned long)os_atomic_load_long(&slot->sequence) - head);
+
+        if (diff == 0) {
+            if (os_atomic_compare_swap_long(&queue->head, (long)head, (long)(head + 1)))
+                break;
+            head = (unsigned long)os_atomic_load_long(&queue->head);
+        } else if (diff < 0) {
+            // 消费者还没读走一整圈之前的命令
+            os_atomic_inc_long(&queue->dropped);
+            return false;
+        } else {
+            head = (unsigned long)os_atomic_load_long(&queue->head);
+        }
+    }
+
+    slot->command = *command;
+
+    // 先写内容再发布序号，消费者看到新的序号时内容已经完整
+    os_atomic_set_long(&slot->sequence, (long)(head + 1));
+    return true;
+}
+
+bool command_queue_pop(struct command_queue *queue, struct zoom_command *command)
+{
+    unsigned long tail = (unsigned long)queue->tail;
+    struct command_slot *slot = &queue->slots[tail & COMMAND_QUEUE_MASK];
+
+    // 已被抢占但还没写完的槽位也视为空，下一帧再读，保持提交顺序
+    if ((unsigned long)os_atomic_load_long(&slot->sequence) != tail + 1)
+        return false;
+
+    *command = slot->command;
+
+    // 读取完成后才把槽位交还给下一圈的生产者
+    os_atomic_set_long(&slot->sequence, (long)(tail + COMMAND_QUEUE_SIZE));
+    queue->tail = (long)(tail + 1);
+    return true;
+}
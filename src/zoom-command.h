@@ -0,0 +1,56 @@
+#ifndef ZOOM_COMMAND_H
+#define ZOOM_COMMAND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 命令队列大小（必须是2的幂）
+#define COMMAND_QUEUE_SIZE 64
+#define COMMAND_QUEUE_MASK (COMMAND_QUEUE_SIZE - 1)
+
+// 命令类型
+#define ZOOM_CMD_IN 0       // 放大键按下/松开
+#define ZOOM_CMD_OUT 1      // 缩小键按下/松开
+#define ZOOM_CMD_RESET 2    // 重置缩放
+#define ZOOM_CMD_ZOOM_TO 3  // 程序控制：过渡到指定缩放值，可同时平移
+#define ZOOM_CMD_ZOOM_BY 4  // 程序控制：在当前目标上增减缩放值
+#define ZOOM_CMD_PAN_TO 5   // 程序控制：平移到指定中心
+
+// 带时间戳的缩放命令
+struct zoom_command {
+    int type;
+    bool pressed;           // 热键命令：按下/松开
+    uint64_t timestamp;     // 命令产生的时间(ns)
+
+    // 程序控制命令的参数
+    float scale;            // ZOOM_TO：目标缩放值；ZOOM_BY：增量
+    float x;                // ZOOM_TO/PAN_TO：中心（源内相对坐标，0-1）；
+    float y;                // ZOOM_TO时负数表示不平移，PAN_TO时负数表示恢复跟踪
+    int64_t duration;       // ZOOM_TO：过渡时长(ns)，负数表示使用设置中的动画时长
+};
+
+// 队列槽位：sequence等于写入位置时可写，等于写入位置+1时内容已完整可读
+struct command_slot {
+    volatile long sequence;
+    struct zoom_command command;
+};
+
+// 多生产者单消费者的有界无锁队列：热键线程和proc_handler的调用线程可以并发写入，
+// 生产者之间只竞争写入位置，不加锁；只有渲染线程读取
+struct command_queue {
+    struct command_slot slots[COMMAND_QUEUE_SIZE];
+    volatile long head;     // 下一个写入位置（生产者原子递增）
+    long tail;              // 下一个读取位置（仅消费者访问）
+    volatile long dropped;  // 队列满时丢弃的命令数
+};
+
+// 初始化队列
+void command_queue_init(struct command_queue *queue);
+
+// 写入一条命令（任意线程），队列满时返回false
+bool command_queue_push(struct command_queue *queue, const struct zoom_command *command);
+
+// 取出一条命令（仅消费者线程调用），队列为空时返回false
+bool command_queue_pop(struct command_queue *queue, struct zoom_command *command);
+
+#endif // ZOOM_COMMAND_H
@@ -0,0 +1,801 @@
+#include "zoom-cursor.h"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <ApplicationServices/ApplicationServices.h>
+#else
+#include <poll.h>
+#include <X11/Xlib.h>
+#include <X11/extensions/XInput2.h>
+#include <X11/extensions/Xrandr.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// X11 后端：libX11 在首次启用跟踪时才通过 dlopen 加载，连接在进程内常驻
+// ---------------------------------------------------------------------------
+#if !defined(_WIN32) && !defined(__APPLE__)
+
+struct x11_funcs {
+    void *lib;
+    Display *(*open_display)(const char *);
+    int (*close_display)(Display *);
+    Bool (*query_pointer)(Display *, Window, Window *, Window *,
+                          int *, int *, int *, int *, unsigned int *);
+    Bool (*query_extension)(Display *, const char *, int *, int *, int *);
+    int (*pending)(Display *);
+    int (*next_event)(Display *, XEvent *);
+    int (*flush)(Display *);
+    Bool (*get_event_data)(Display *, XGenericEventCookie *);
+    void (*free_event_data)(Display *, XGenericEventCookie *);
+
+    // libXi（可选，用于XInput2原始移动事件、滚轮和捏合手势）
+    void *xi_lib;
+    Status (*xi_query_version)(Display *, int *, int *);
+    int (*xi_select_events)(Display *, Window, XIEventMask *, int);
+
+    // libXrandr（可选，用于枚举显示器和接收布局变化事件）
+    void *xrr_lib;
+    Bool (*xrr_query_extension)(Display *, int *, int *);
+    void (*xrr_select_input)(Display *, Window, int);
+    XRRMonitorInfo *(*xrr_get_monitors)(Display *, Window, Bool, int *);
+    void (*xrr_free_monitors)(XRRMonitorInfo *);
+};
+
+static struct x11_funcs x11 = {0};
+static Display *x11_display = NULL;
+static int xi_opcode = -1;
+static int xrr_event_base = -1;
+static bool x11_layout_changed = true;
+
+// 缩放手势累计量（仅采样线程读写）
+static struct cursor_gesture x11_gesture = {0};
+static bool x11_gesture_pending = false;
+static double x11_pinch_scale = 1.0;   // 当前捏合手势上一次报告的累计比例
+
+// 订阅根窗口上的XInput2原始移动和按键事件，失败时采样线程使用轮询；
+// 服务器支持XI 2.4时同时订阅触摸板捏合手势
+static void x11_init_xi2(void)
+{
+#ifdef XI_GesturePinchUpdate
+    int event, error, major = 2, minor = 4;
+#else
+    int event, error, major = 2, minor = 0;
+#endif
+    unsigned char mask_bits[XIMaskLen(XI_LASTEVENT)] = {0};
+    XIEventMask mask;
+
+    if (!x11.query_extension || !x11.pending || !x11.next_event || !x11.flush)
+        return;
+    if (!x11.query_extension(x11_display, "XInputExtension", &xi_opcode, &event, &error)) {
+        xi_opcode = -1;
+        return;
+    }
+
+    x11.xi_lib = os_dlopen("libXi.so.6");
+    if (!x11.xi_lib)
+        goto fail;
+
+    x11.xi_query_version = os_dlsym(x11.xi_lib, "XIQueryVersion");
+    x11.xi_select_events = os_dlsym(x11.xi_lib, "XISelectEvents");
+    if (!x11.xi_query_version || !x11.xi_select_events ||
+        x11.xi_query_version(x11_display, &major, &minor) != Success)
+        goto fail;
+
+    XISetMask(mask_bits, XI_RawMotion);
+    if (x11.get_event_data && x11.free_event_data) {
+        XISetMask(mask_bits, XI_RawButtonPress);
+#ifdef XI_GesturePinchUpdate
+        if (minor >= 4) {
+            XISetMask(mask_bits, XI_GesturePinchBegin);
+            XISetMask(mask_bits, XI_GesturePinchUpdate);
+        }
+#endif
+    }
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(mask_bits);
+    mask.mask = mask_bits;
+    x11.xi_select_events(x11_display, DefaultRootWindow(x11_display), &mask, 1);
+    x11.flush(x11_display);
+
+    blog(LOG_INFO, "[zoom-cursor] XInput2 %d.%d raw motion events enabled", major, minor);
+    return;
+
+fail:
+    blog(LOG_INFO, "[zoom-cursor] XInput2 not available, falling back to polling");
+    if (x11.xi_lib)
+        os_dlclose(x11.xi_lib);
+    x11.xi_lib = NULL;
+    x11.xi_query_version = NULL;
+    x11.xi_select_events = NULL;
+    xi_opcode = -1;
+}
+
+// 订阅RandR布局变化事件，不可用时只报告整个根窗口
+static void x11_init_xrandr(void)
+{
+    int error;
+
+    x11.xrr_lib = os_dlopen("libXrandr.so.2");
+    if (!x11.xrr_lib)
+        goto fail;
+
+    x11.xrr_query_extension = os_dlsym(x11.xrr_lib, "XRRQueryExtension");
+    x11.xrr_select_input = os_dlsym(x11.xrr_lib, "XRRSelectInput");
+    x11.xrr_get_monitors = os_dlsym(x11.xrr_lib, "XRRGetMonitors");
+    x11.xrr_free_monitors = os_dlsym(x11.xrr_lib, "XRRFreeMonitors");
+    if (!x11.xrr_query_extension || !x11.xrr_select_input ||
+        !x11.xrr_get_monitors || !x11.xrr_free_monitors ||
+        !x11.xrr_query_extension(x11_display, &xrr_event_base, &error))
+        goto fail;
+
+    x11.xrr_select_input(x11_display, DefaultRootWindow(x11_display),
+                         RRScreenChangeNotifyMask | RRCrtcChangeNotifyMask);
+    if (x11.flush)
+        x11.flush(x11_display);
+    return;
+
+fail:
+    blog(LOG_INFO, "[zoom-cursor] RandR 1.5 not available, using the root window as the only monitor");
+    if (x11.xrr_lib)
+        os_dlclose(x11.xrr_lib);
+    x11.xrr_lib = NULL;
+    x11.xrr_get_monitors = NULL;
+    xrr_event_base = -1;
+}
+
+static bool x11_open(void)
+{
+    x11.lib = os_dlopen("libX11.so.6");
+    if (!x11.lib) {
+        blog(LOG_WARNING, "[zoom-cursor] libX11 not available, mouse tracking disabled");
+        return false;
+    }
+
+    x11.open_display = os_dlsym(x11.lib, "XOpenDisplay");
+    x11.close_display = os_dlsym(x11.lib, "XCloseDisplay");
+    x11.query_pointer = os_dlsym(x11.lib, "XQueryPointer");
+    x11.query_extension = os_dlsym(x11.lib, "XQueryExtension");
+    x11.pending = os_dlsym(x11.lib, "XPending");
+    x11.next_event = os_dlsym(x11.lib, "XNextEvent");
+    x11.flush = os_dlsym(x11.lib, "XFlush");
+    x11.get_event_data = os_dlsym(x11.lib, "XGetEventData");
+    x11.free_event_data = os_dlsym(x11.lib, "XFreeEventData");
+    if (!x11.open_display || !x11.close_display || !x11.query_pointer) {
+        blog(LOG_WARNING, "[zoom-cursor] libX11 is missing required symbols");
+        goto fail;
+    }
+
+    x11_display = x11.open_display(NULL);
+    if (!x11_display) {
+        blog(LOG_WARNING, "[zoom-cursor] XOpenDisplay failed");
+        goto fail;
+    }
+
+    x11_init_xi2();
+    x11_init_xrandr();
+    return true;
+
+fail:
+    os_dlclose(x11.lib);
+    memset(&x11, 0, sizeof(x11));
+    return false;
+}
+
+static void x11_close(void)
+{
+    if (x11_display)
+        x11.close_display(x11_display);
+    x11_display = NULL;
+    xi_opcode = -1;
+    xrr_event_base = -1;
+    x11_layout_changed = true;
+    memset(&x11_gesture, 0, sizeof(x11_gesture));
+    x11_gesture_pending = false;
+    x11_pinch_scale = 1.0;
+
+    if (x11.xi_lib)
+        os_dlclose(x11.xi_lib);
+    if (x11.xrr_lib)
+        os_dlclose(x11.xrr_lib);
+    if (x11.lib)
+        os_dlclose(x11.lib);
+    memset(&x11, 0, sizeof(x11));
+}
+
+// 读取XInput2滚轮和捏合事件的数据，返回滚轮格数（向上为正），捏合比例直接累加
+static float x11_handle_gesture(XGenericEventCookie *cookie)
+{
+    float wheel = 0.0f;
+
+    if (!x11.get_event_data(x11_display, cookie))
+        return 0.0f;
+
+    if (cookie->evtype == XI_RawButtonPress) {
+        const XIRawEvent *raw = cookie->data;
+        if (raw->detail == 4)
+            wheel = 1.0f;
+        else if (raw->detail == 5)
+            wheel = -1.0f;
+    }
+#ifdef XI_GesturePinchUpdate
+    else if (cookie->evtype == XI_GesturePinchBegin) {
+        x11_pinch_scale = 1.0;
+    } else if (cookie->evtype == XI_GesturePinchUpdate) {
+        const XIGesturePinchEvent *pinch = cookie->data;
+        if (pinch->scale > 0.0 && x11_pinch_scale > 0.0) {
+            x11_gesture.pinch += (float)log(pinch->scale / x11_pinch_scale);
+            x11_gesture_pending = true;
+        }
+        x11_pinch_scale = pinch->scale;
+    }
+#endif
+
+    x11.free_event_data(x11_display, cookie);
+    return wheel;
+}
+
+// 滚轮格数按事件处理完时按住的修饰键累加（原始事件不带修饰键状态）
+static void x11_add_wheel(float wheel)
+{
+    Window root, child;
+    int root_x, root_y, win_x, win_y;
+    unsigned int mask;
+
+    if (!x11.query_pointer(x11_display, DefaultRootWindow(x11_display),
+                           &root, &child, &root_x, &root_y, &win_x, &win_y, &mask))
+        return;
+
+    if (mask & ControlMask)
+        x11_gesture.wheel[CURSOR_MOD_CTRL] += wheel;
+    if (mask & Mod1Mask)
+        x11_gesture.wheel[CURSOR_MOD_ALT] += wheel;
+    if (mask & ShiftMask)
+        x11_gesture.wheel[CURSOR_MOD_SHIFT] += wheel;
+    if (mask & Mod4Mask)
+        x11_gesture.wheel[CURSOR_MOD_SUPER] += wheel;
+    x11_gesture_pending = true;
+}
+
+// 处理所有待处理事件，返回是否收到原始移动事件（同时记录RandR布局变化，累加滚轮和捏合）
+static bool x11_drain_events(void)
+{
+    bool moved = false;
+    float wheel = 0.0f;
+    XEvent ev;
+
+    while (x11.pending(x11_display) > 0) {
+        x11.next_event(x11_display, &ev);
+        if (ev.xcookie.type == GenericEvent &&
+            ev.xcookie.extension == xi_opcode) {
+            if (ev.xcookie.evtype == XI_RawMotion)
+                moved = true;
+            else
+                wheel += x11_handle_gesture(&ev.xcookie);
+        } else if (xrr_event_base >= 0 &&
+                   (ev.type == xrr_event_base + RRScreenChangeNotify ||
+                    ev.type == xrr_event_base + RRNotify))
+            x11_layout_changed = true;
+    }
+
+    if (wheel != 0.0f)
+        x11_add_wheel(wheel);
+
+    return moved;
+}
+
+static bool x11_wait_motion(uint64_t timeout_ns)
+{
+    struct pollfd pfd;
+
+    if (!x11_display || xi_opcode < 0)
+        return false;
+
+    // Xlib可能已把事件读入本地队列，先处理掉再poll
+    if (x11_drain_events())
+        return true;
+
+    pfd.fd = ConnectionNumber(x11_display);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, (int)(timeout_ns / 1000000)) <= 0)
+        return false;
+
+    return x11_drain_events();
+}
+
+static bool x11_has_events(void)
+{
+    return xi_opcode >= 0;
+}
+
+static bool x11_query(float *x, float *y)
+{
+    Window root, child;
+    int root_x, root_y, win_x, win_y;
+    unsigned int mask;
+
+    if (!x11_display)
+        return false;
+
+    if (!x11.query_pointer(x11_display, DefaultRootWindow(x11_display),
+                           &root, &child, &root_x, &root_y, &win_x, &win_y, &mask))
+        return false;
+
+    *x = (float)root_x;
+    *y = (float)root_y;
+    return true;
+}
+
+static int x11_get_monitors(struct cursor_monitor *monitors, int max)
+{
+    int count = 0;
+
+    if (!x11_display || max <= 0)
+        return 0;
+
+    if (x11.xrr_get_monitors) {
+        XRRMonitorInfo *info = x11.xrr_get_monitors(x11_display,
+                                                    DefaultRootWindow(x11_display),
+                                                    True, &count);
+        if (info) {
+            count = count < max ? count : max;
+            for (int i = 0; i < count; i++) {
+                monitors[i].x = info[i].x;
+                monitors[i].y = info[i].y;
+                monitors[i].width = info[i].width;
+                monitors[i].height = info[i].height;
+            }
+            x11.xrr_free_monitors(info);
+            if (count > 0)
+                return count;
+        }
+    }
+
+    // 无RandR：整个根窗口视为一个显示器
+    monitors[0].x = 0;
+    monitors[0].y = 0;
+    monitors[0].width = DisplayWidth(x11_display, DefaultScreen(x11_display));
+    monitors[0].height = DisplayHeight(x11_display, DefaultScreen(x11_display));
+    return 1;
+}
+
+static bool x11_monitors_changed(void)
+{
+    bool changed;
+
+    if (!x11_display)
+        return false;
+
+    // 轮询模式下没有其他地方读取事件，这里顺便处理
+    if (xi_opcode < 0 && xrr_event_base >= 0 && x11.pending && x11.next_event)
+        x11_drain_events();
+
+    changed = x11_layout_changed;
+    x11_layout_changed = false;
+    return changed;
+}
+
+static bool x11_take_gesture(struct cursor_gesture *gesture)
+{
+    if (!x11_gesture_pending)
+        return false;
+
+    *gesture = x11_gesture;
+    memset(&x11_gesture, 0, sizeof(x11_gesture));
+    x11_gesture_pending = false;
+    return true;
+}
+
+const struct cursor_backend cursor_backend_x11 = {
+    .name = "x11",
+    .open = x11_open,
+    .close = x11_close,
+    .query = x11_query,
+    .has_events = x11_has_events,
+    .wait_motion = x11_wait_motion,
+    .get_monitors = x11_get_monitors,
+    .monitors_changed = x11_monitors_changed,
+    .take_gesture = x11_take_gesture,
+};
+
+#define DEFAULT_BACKEND (&cursor_backend_x11)
+
+#endif
+
+// ---------------------------------------------------------------------------
+// Win32 后端
+// ---------------------------------------------------------------------------
+#ifdef _WIN32
+
+static bool win32_open(void)
+{
+    return true;
+}
+
+static void win32_close(void)
+{
+}
+
+static bool win32_query(float *x, float *y)
+{
+    POINT mouse_pos;
+    if (!GetCursorPos(&mouse_pos))
+        return false;
+
+    *x = (float)mouse_pos.x;
+    *y = (float)mouse_pos.y;
+    return true;
+}
+
+struct win32_monitor_list {
+    struct cursor_monitor *monitors;
+    int max;
+    int count;
+};
+
+static BOOL CALLBACK win32_enum_monitor(HMONITOR monitor, HDC hdc, LPRECT rect, LPARAM param)
+{
+    struct win32_monitor_list *list = (struct win32_monitor_list *)param;
+
+    UNUSED_PARAMETER(monitor);
+    UNUSED_PARAMETER(hdc);
+
+    if (list->count >= list->max)
+        return FALSE;
+
+    list->monitors[list->count].x = rect->left;
+    list->monitors[list->count].y = rect->top;
+    list->monitors[list->count].width = rect->right - rect->left;
+    list->monitors[list->count].height = rect->bottom - rect->top;
+    list->count++;
+    return TRUE;
+}
+
+static int win32_get_monitors(struct cursor_monitor *monitors, int max)
+{
+    struct win32_monitor_list list = {monitors, max, 0};
+
+    EnumDisplayMonitors(NULL, NULL, win32_enum_monitor, (LPARAM)&list);
+    return list.count;
+}
+
+// 用虚拟桌面尺寸和显示器数量判断布局变化（读取共享内存，开销很小）
+static bool win32_monitors_changed(void)
+{
+    static int last[5] = {0};
+    int now[5] = {
+        GetSystemMetrics(SM_XVIRTUALSCREEN),
+        GetSystemMetrics(SM_YVIRTUALSCREEN),
+        GetSystemMetrics(SM_CXVIRTUALSCREEN),
+        GetSystemMetrics(SM_CYVIRTUALSCREEN),
+        GetSystemMetrics(SM_CMONITORS),
+    };
+
+    if (memcmp(now, last, sizeof(now)) == 0)
+        return false;
+
+    memcpy(last, now, sizeof(now));
+    return true;
+}
+
+const struct cursor_backend cursor_backend_win32 = {
+    .name = "win32",
+    .open = win32_open,
+    .close = win32_close,
+    .query = win32_query,
+    .has_events = NULL,
+    .wait_motion = NULL,
+    .get_monitors = win32_get_monitors,
+    .monitors_changed = win32_monitors_changed,
+};
+
+#define DEFAULT_BACKEND (&cursor_backend_win32)
+
+#endif
+
+// ---------------------------------------------------------------------------
+// CoreGraphics 后端
+// ---------------------------------------------------------------------------
+#ifdef __APPLE__
+
+static volatile bool cg_layout_changed = true;
+
+static void cg_reconfigured(CGDirectDisplayID display, CGDisplayChangeSummaryFlags flags,
+                            void *param)
+{
+    UNUSED_PARAMETER(display);
+    UNUSED_PARAMETER(param);
+
+    if (!(flags & kCGDisplayBeginConfigurationFlag))
+        os_atomic_set_bool(&cg_layout_changed, true);
+}
+
+static bool cg_open(void)
+{
+    CGDisplayRegisterReconfigurationCallback(cg_reconfigured, NULL);
+    return true;
+}
+
+static void cg_close(void)
+{
+    CGDisplayRemoveReconfigurationCallback(cg_reconfigured, NULL);
+}
+
+static bool cg_query(float *x, float *y)
+{
+    CGEventRef event = CGEventCreate(NULL);
+    if (!event)
+        return false;
+
+    CGPoint mouse_pos = CGEventGetLocation(event);
+    CFRelease(event);
+    *x = (float)mouse_pos.x;
+    *y = (float)mouse_pos.y;
+    return true;
+}
+
+static int cg_get_monitors(struct cursor_monitor *monitors, int max)
+{
+    CGDirectDisplayID displays[CURSOR_MAX_MONITORS];
+    uint32_t count = 0;
+
+    if (max > CURSOR_MAX_MONITORS)
+        max = CURSOR_MAX_MONITORS;
+    if (CGGetActiveDisplayList((uint32_t)max, displays, &count) != kCGErrorSuccess)
+        return 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        CGRect bounds = CGDisplayBounds(displays[i]);
+        monitors[i].x = (int)bounds.origin.x;
+        monitors[i].y = (int)bounds.origin.y;
+        monitors[i].width = (int)bounds.size.width;
+        monitors[i].height = (int)bounds.size.height;
+    }
+    return (int)count;
+}
+
+static bool cg_monitors_changed(void)
+{
+    return os_atomic_exchange_bool(&cg_layout_changed, false);
+}
+
+const struct cursor_backend cursor_backend_cg = {
+    .name = "coregraphics",
+    .open = cg_open,
+    .close = cg_close,
+    .query = cg_query,
+    .has_events = NULL,
+    .wait_motion = NULL,
+    .get_monitors = cg_get_monitors,
+    .monitors_changed = cg_monitors_changed,
+};
+
+#define DEFAULT_BACKEND (&cursor_backend_cg)
+
+#endif
+
+// ---------------------------------------------------------------------------
+// 测试桩
+// ---------------------------------------------------------------------------
+static float stub_x = 0.0f;
+static float stub_y = 0.0f;
+static struct cursor_monitor stub_monitors[CURSOR_MAX_MONITORS];
+static int stub_monitor_count = 0;
+static volatile bool stub_layout_changed = true;
+static pthread_mutex_t stub_gesture_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct cursor_gesture stub_gesture = {0};
+static bool stub_gesture_pending = false;
+
+static bool stub_open(void)
+{
+    return true;
+}
+
+static void stub_close(void)
+{
+}
+
+static bool stub_query(float *x, float *y)
+{
+    *x = stub_x;
+    *y = stub_y;
+    return true;
+}
+
+static int stub_get_monitors(struct cursor_monitor *monitors, int max)
+{
+    int count = stub_monitor_count < max ? stub_monitor_count : max;
+    memcpy(monitors, stub_monitors, sizeof(*monitors) * (size_t)count);
+    return count;
+}
+
+static bool stub_monitors_changed(void)
+{
+    return os_atomic_exchange_bool(&stub_layout_changed, false);
+}
+
+static bool stub_take_gesture(struct cursor_gesture *gesture)
+{
+    bool pending;
+
+    pthread_mutex_lock(&stub_gesture_mutex);
+    pending = stub_gesture_pending;
+    if (pending) {
+        *gesture = stub_gesture;
+        memset(&stub_gesture, 0, sizeof(stub_gesture));
+        stub_gesture_pending = false;
+    }
+    pthread_mutex_unlock(&stub_gesture_mutex);
+
+    return pending;
+}
+
+const struct cursor_backend cursor_backend_stub = {
+    .name = "stub",
+    .open = stub_open,
+    .close = stub_close,
+    .query = stub_query,
+    .has_events = NULL,
+    .wait_motion = NULL,
+    .get_monitors = stub_get_monitors,
+    .monitors_changed = stub_monitors_changed,
+    .take_gesture = stub_take_gesture,
+};
+
+void cursor_stub_set_pos(float x, float y)
+{
+    stub_x = x;
+    stub_y = y;
+}
+
+void cursor_stub_set_monitors(const struct cursor_monitor *monitors, int count)
+{
+    if (count > CURSOR_MAX_MONITORS)
+        count = CURSOR_MAX_MONITORS;
+    memcpy(stub_monitors, monitors, sizeof(*monitors) * (size_t)count);
+    stub_monitor_count = count;
+    os_atomic_set_bool(&stub_layout_changed, true);
+}
+
+void cursor_stub_add_gesture(int modifier, float wheel, float pinch_ratio)
+{
+    pthread_mutex_lock(&stub_gesture_mutex);
+    if (modifier >= 0 && modifier < CURSOR_MOD_COUNT)
+        stub_gesture.wheel[modifier] += wheel;
+    if (pinch_ratio > 0.0f)
+        stub_gesture.pinch += logf(pinch_ratio);
+    stub_gesture_pending = true;
+    pthread_mutex_unlock(&stub_gesture_mutex);
+}
+
+// ---------------------------------------------------------------------------
+// 进程级共享连接
+// ---------------------------------------------------------------------------
+static pthread_mutex_t cursor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static const struct cursor_backend *selected_backend = NULL;
+static const struct cursor_backend *active_backend = NULL;
+static bool open_attempted = false;
+static long cursor_refs = 0;
+
+void cursor_backend_select(const struct cursor_backend *backend)
+{
+    pthread_mutex_lock(&cursor_mutex);
+    if (!active_backend)
+        selected_backend = backend;
+    else
+        blog(LOG_WARNING, "[zoom-cursor] backend already in use, selection ignored");
+    pthread_mutex_unlock(&cursor_mutex);
+}
+
+bool cursor_backend_acquire(void)
+{
+    bool success;
+
+    pthread_mutex_lock(&cursor_mutex);
+    cursor_refs++;
+
+    // 连接只建立一次，此后在进程内常驻直到模块卸载
+    if (!active_backend && !open_attempted) {
+        const struct cursor_backend *backend =
+            selected_backend ? selected_backend : DEFAULT_BACKEND;
+
+        open_attempted = true;
+        if (backend->open()) {
+            active_backend = backend;
+            blog(LOG_INFO, "[zoom-cursor] using '%s' cursor backend", backend->name);
+        }
+    }
+    success = active_backend != NULL;
+    pthread_mutex_unlock(&cursor_mutex);
+
+    return success;
+}
+
+void cursor_backend_release(void)
+{
+    pthread_mutex_lock(&cursor_mutex);
+    if (cursor_refs > 0)
+        cursor_refs--;
+    pthread_mutex_unlock(&cursor_mutex);
+}
+
+void cursor_backend_shutdown(void)
+{
+    pthread_mutex_lock(&cursor_mutex);
+    if (active_backend)
+        active_backend->close();
+    active_backend = NULL;
+    open_attempted = false;
+    cursor_refs = 0;
+    pthread_mutex_unlock(&cursor_mutex);
+}
+
+bool cursor_backend_query(float *x, float *y)
+{
+    bool success = false;
+
+    pthread_mutex_lock(&cursor_mutex);
+    if (active_backend)
+        success = active_backend->query(x, y);
+    pthread_mutex_unlock(&cursor_mutex);
+
+    return success;
+}
+
+bool cursor_backend_has_events(void)
+{
+    const struct cursor_backend *backend = active_backend;
+
+    if (!backend || !backend->has_events || !backend->wait_motion)
+        return false;
+    return backend->has_events();
+}
+
+bool cursor_backend_wait_motion(uint64_t timeout_ns)
+{
+    const struct cursor_backend *backend = active_backend;
+
+    // 事件连接只由采样线程使用，这里不加锁以免阻塞查询
+    if (!backend || !backend->wait_motion)
+        return false;
+    return backend->wait_motion(timeout_ns);
+}
+
+int cursor_backend_get_monitors(struct cursor_monitor *monitors, int max)
+{
+    int count = 0;
+
+    pthread_mutex_lock(&cursor_mutex);
+    if (active_backend && active_backend->get_monitors)
+        count = active_backend->get_monitors(monitors, max);
+    pthread_mutex_unlock(&cursor_mutex);
+
+    return count;
+}
+
+bool cursor_backend_monitors_changed(void)
+{
+    bool changed = false;
+
+    pthread_mutex_lock(&cursor_mutex);
+    if (active_backend && active_backend->monitors_changed)
+        changed = active_backend->monitors_changed();
+    pthread_mutex_unlock(&cursor_mutex);
+
+    return changed;
+}
+
+bool cursor_backend_take_gesture(struct cursor_gesture *gesture)
+{
+    const struct cursor_backend *backend = active_backend;
+
+    // 与wait_motion一样只由采样线程使用
+    if (!backend || !backend->take_gesture)
+        return false;
+    return backend->take_gesture(gesture);
+}
@@ -0,0 +1,98 @@
+#ifndef ZOOM_CURSOR_H
+#define ZOOM_CURSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 最多支持的显示器数量
+#define CURSOR_MAX_MONITORS 16
+
+// 显示器在桌面坐标中的矩形（像素）
+struct cursor_monitor {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// 修饰键（缩放手势使用）
+#define CURSOR_MOD_CTRL 0
+#define CURSOR_MOD_ALT 1
+#define CURSOR_MOD_SHIFT 2
+#define CURSOR_MOD_SUPER 3
+#define CURSOR_MOD_COUNT 4
+
+// 缩放手势输入：后端在事件线程累加，自上次读取以来的总量
+struct cursor_gesture {
+    float wheel[CURSOR_MOD_COUNT];  // 按住各修饰键时滚轮转动的格数（向上为正）
+    float pinch;                    // 触摸板捏合缩放比例的自然对数之和（张开为正）
+};
+
+// 光标后端接口（每个平台一个实现）
+struct cursor_backend {
+    const char *name;
+    bool (*open)(void);                 // 建立连接/加载库，进程内只调用一次
+    void (*close)(void);                // 断开连接/卸载库
+    bool (*query)(float *x, float *y);  // 查询光标桌面坐标（像素）
+
+    // 事件驱动采样（可选）：has_events为NULL或返回false时采样线程退化为轮询
+    bool (*has_events)(void);
+    bool (*wait_motion)(uint64_t timeout_ns);   // 阻塞等待移动事件，超时返回false
+
+    // 显示器布局（可选）：枚举显示器，以及检查自上次枚举后布局是否变化
+    int (*get_monitors)(struct cursor_monitor *monitors, int max);
+    bool (*monitors_changed)(void);
+
+    // 缩放手势（可选）：取出并清零累计的滚轮和捏合输入，没有新输入时返回false
+    bool (*take_gesture)(struct cursor_gesture *gesture);
+};
+
+// 平台后端
+#ifdef _WIN32
+extern const struct cursor_backend cursor_backend_win32;
+#elif defined(__APPLE__)
+extern const struct cursor_backend cursor_backend_cg;
+#else
+extern const struct cursor_backend cursor_backend_x11;
+#endif
+// 测试桩：位置由 cursor_stub_set_pos() 指定
+extern const struct cursor_backend cursor_backend_stub;
+
+// 指定使用的后端（必须在首次获取之前调用，NULL表示平台默认）
+void cursor_backend_select(const struct cursor_backend *backend);
+
+// 获取/释放后端引用，首次获取时才打开连接，连接常驻到模块卸载
+bool cursor_backend_acquire(void);
+void cursor_backend_release(void);
+
+// 关闭连接（模块卸载时调用）
+void cursor_backend_shutdown(void);
+
+// 查询光标位置，后端不可用时返回false
+bool cursor_backend_query(float *x, float *y);
+
+// 后端是否支持事件驱动采样
+bool cursor_backend_has_events(void);
+
+// 等待光标移动事件（仅采样线程调用）
+bool cursor_backend_wait_motion(uint64_t timeout_ns);
+
+// 枚举显示器，返回数量（后端不支持时返回0，仅采样线程调用）
+int cursor_backend_get_monitors(struct cursor_monitor *monitors, int max);
+
+// 显示器布局是否变化（仅采样线程调用）
+bool cursor_backend_monitors_changed(void);
+
+// 取出累计的缩放手势（仅采样线程调用，后端不支持时返回false）
+bool cursor_backend_take_gesture(struct cursor_gesture *gesture);
+
+// 设置测试桩返回的光标位置
+void cursor_stub_set_pos(float x, float y);
+
+// 设置测试桩报告的显示器布局（同时标记布局已变化）
+void cursor_stub_set_monitors(const struct cursor_monitor *monitors, int count);
+
+// 向测试桩注入滚轮格数（按住modifier）和捏合比例
+void cursor_stub_add_gesture(int modifier, float wheel, float pinch_ratio);
+
+#endif // ZOOM_CURSOR_H
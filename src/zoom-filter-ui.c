@@ -1,10 +1,12 @@
 #include <obs-module.h>
 #include <util/platform.h>
 #include <util/base.h>
+#include <util/threading.h>
 #include <stdio.h>
 #include "plugin-support.h"
 #include "zoom-filter-ui.h"
 #include "zoom-filter.h"
+#include "zoom-sampler.h"
 #include "url-handler.h"
 
 #ifdef _WIN32
@@ -61,12 +63,38 @@ static obs_properties_t *add_zoom_step_group(obs_properties_t *props)
     
     obs_properties_add_float_slider(zoom_group, S_SINGLE_STEP,
         obs_module_text("SingleClickStep"), 0.01, 5.0, 0.01);
-    obs_properties_add_float_slider(zoom_group, S_CONT_STEP,
-        obs_module_text("ContinuousStep"), 0.001, 5.0, 0.001);
+    
+    // 长按时的连续缩放速度
+    obs_properties_add_float_slider(zoom_group, S_ZOOM_RATE,
+        obs_module_text("ZoomRate"), 0.1, 10.0, 0.1);
+    obs_property_t *relative = obs_properties_add_bool(zoom_group, S_ZOOM_RATE_RELATIVE,
+        obs_module_text("ZoomRateRelative"));
+    obs_property_set_long_description(relative, obs_module_text("ZoomRateRelativeDescription"));
+    obs_properties_add_int_slider(zoom_group, S_ZOOM_RAMP,
+        obs_module_text("ZoomRamp"), 0, 2000, 10);
 
     return zoom_group;
 }
 
+static obs_properties_t *add_gesture_group(obs_properties_t *props)
+{
+    obs_properties_t *gesture_group = obs_properties_create();
+
+    obs_property_t *modifier_list = obs_properties_add_list(gesture_group, S_WHEEL_MODIFIER,
+        obs_module_text("WheelModifier"),
+        OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(modifier_list, obs_module_text("ModifierCtrl"), CURSOR_MOD_CTRL);
+    obs_property_list_add_int(modifier_list, obs_module_text("ModifierAlt"), CURSOR_MOD_ALT);
+    obs_property_list_add_int(modifier_list, obs_module_text("ModifierShift"), CURSOR_MOD_SHIFT);
+    obs_property_list_add_int(modifier_list, obs_module_text("ModifierSuper"), CURSOR_MOD_SUPER);
+    obs_property_set_long_description(modifier_list,
+        obs_module_text("WheelModifierDescription"));
+    obs_properties_add_int_slider(gesture_group, S_WHEEL_STEP,
+        obs_module_text("WheelStep"), 1, 50, 1);
+
+    return gesture_group;
+}
+
 static obs_properties_t *add_smooth_group(obs_properties_t *props)
 {
     obs_properties_t *smooth_group = obs_properties_create();
@@ -83,6 +111,8 @@ static obs_properties_t *add_smooth_group(obs_properties_t *props)
         SMOOTH_MODE_EXPONENTIAL);
     obs_property_list_add_int(list, obs_module_text("Logarithmic"),
         SMOOTH_MODE_LOGARITHMIC);
+    obs_property_list_add_int(list, obs_module_text("Spring"),
+        SMOOTH_MODE_SPRING);
         
     // 添加高级平滑控制选项
     obs_properties_add_float_slider(smooth_group, S_START_SPEED,
@@ -105,10 +135,124 @@ static obs_properties_t *add_time_control_group(obs_properties_t *props)
         obs_module_text("AnimationTime"), 0, 1000, 10);
     obs_properties_add_int_slider(time_group, S_AUTO_RESET,
         obs_module_text("AutoResetTime"), 0, 10000, 100);
+    obs_properties_add_bool(time_group, S_MIDFRAME_EVAL,
+        obs_module_text("MidframeEval"));
 
     return time_group;
 }
-<<<<<<< HEAD
+
+static obs_properties_t *add_record_group(obs_properties_t *props)
+{
+    obs_properties_t *record_group = obs_properties_create();
+    char filter[128];
+
+    obs_property_t *mode_list = obs_properties_add_list(record_group, S_RECORD_MODE,
+        obs_module_text("RecordMode"),
+        OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(mode_list, obs_module_text("RecordOff"), RECORD_MODE_OFF);
+    obs_property_list_add_int(mode_list, obs_module_text("RecordRecord"), RECORD_MODE_RECORD);
+    obs_property_list_add_int(mode_list, obs_module_text("RecordReplay"), RECORD_MODE_REPLAY);
+
+    snprintf(filter, sizeof(filter), "%s (*.zlog)", obs_module_text("ZoomLogFiles"));
+    obs_properties_add_path(record_group, S_RECORD_PATH,
+        obs_module_text("RecordPath"), OBS_PATH_FILE_SAVE, filter, NULL);
+    obs_properties_add_path(record_group, S_REPLAY_PATH,
+        obs_module_text("ReplayPath"), OBS_PATH_FILE, filter, NULL);
+
+    return record_group;
+}
+
+static bool restart_timeline_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+    UNUSED_PARAMETER(props);
+    UNUSED_PARAMETER(property);
+
+    if (data)
+        zoom_filter_restart_timeline(data);
+    return false;
+}
+
+static obs_properties_t *add_timeline_group(obs_properties_t *props)
+{
+    obs_properties_t *timeline_group = obs_properties_create();
+    char filter[128];
+
+    snprintf(filter, sizeof(filter), "%s (*.json)", obs_module_text("TimelineFiles"));
+    obs_properties_add_path(timeline_group, S_TIMELINE_PATH,
+        obs_module_text("TimelinePath"), OBS_PATH_FILE, filter, NULL);
+    obs_properties_add_button(timeline_group, S_TIMELINE_RESTART,
+        obs_module_text("TimelineRestart"),
+        restart_timeline_clicked);
+
+    return timeline_group;
+}
+
+// 采样率统计窗口(ns)
+#define DIAG_RATE_WINDOW_NS 1000000000ULL
+
+static void set_diag_text(obs_properties_t *props, const char *name, const char *text)
+{
+    obs_property_t *property = obs_properties_get(props, name);
+    if (property)
+        obs_property_set_description(property, text);
+}
+
+// 从统计块读取一次最新数据，写入诊断组各项的说明文字（不经过设置，也不会被保存）
+static void update_diagnostics(obs_properties_t *props, struct zoom_filter *filter)
+{
+    const struct zoom_stats *stats = &filter->stats;
+    char text[256];
+
+    snprintf(text, sizeof(text), obs_module_text("DiagScale"),
+        (double)os_atomic_load_long(&stats->live.current_scale) / 1000.0,
+        (double)os_atomic_load_long(&stats->live.target_scale) / 1000.0);
+    set_diag_text(props, S_DIAG_SCALE, text);
+
+    snprintf(text, sizeof(text), obs_module_text("DiagCenter"),
+        os_atomic_load_long(&stats->live.center_x),
+        os_atomic_load_long(&stats->live.center_y));
+    set_diag_text(props, S_DIAG_CENTER, text);
+
+    snprintf(text, sizeof(text), obs_module_text("DiagSampleRate"),
+        cursor_sampler_sample_rate(os_gettime_ns(), DIAG_RATE_WINDOW_NS));
+    set_diag_text(props, S_DIAG_SAMPLE_RATE, text);
+
+    snprintf(text, sizeof(text), obs_module_text("DiagRenderPaths"),
+        os_atomic_load_long(&stats->live.identity_frames),
+        os_atomic_load_long(&stats->live.transform_frames));
+    set_diag_text(props, S_DIAG_RENDER_PATHS, text);
+
+    snprintf(text, sizeof(text), obs_module_text("DiagFrameCost"),
+        (double)histogram_percentile(&stats->frame_cost, 0.50f) / 1000000.0,
+        (double)histogram_percentile(&stats->frame_cost, 0.99f) / 1000000.0);
+    set_diag_text(props, S_DIAG_FRAME_COST, text);
+}
+
+static bool refresh_diagnostics_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+    UNUSED_PARAMETER(property);
+
+    if (data)
+        update_diagnostics(props, data);
+    return true;
+}
+
+static obs_properties_t *add_diagnostics_group(struct zoom_filter *filter)
+{
+    obs_properties_t *diag_group = obs_properties_create();
+
+    obs_properties_add_text(diag_group, S_DIAG_SCALE, "", OBS_TEXT_INFO);
+    obs_properties_add_text(diag_group, S_DIAG_CENTER, "", OBS_TEXT_INFO);
+    obs_properties_add_text(diag_group, S_DIAG_SAMPLE_RATE, "", OBS_TEXT_INFO);
+    obs_properties_add_text(diag_group, S_DIAG_RENDER_PATHS, "", OBS_TEXT_INFO);
+    obs_properties_add_text(diag_group, S_DIAG_FRAME_COST, "", OBS_TEXT_INFO);
+    obs_properties_add_button(diag_group, S_DIAG_REFRESH,
+        obs_module_text("DiagRefresh"),
+        refresh_diagnostics_clicked);
+
+    update_diagnostics(diag_group, filter);
+    return diag_group;
+}
 
 static obs_properties_t *add_support_group(obs_properties_t *props)
 {
@@ -124,12 +268,10 @@ static obs_properties_t *add_support_group(obs_properties_t *props)
 
     return support_group;
 }
-=======
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
 
 obs_properties_t *zoom_filter_get_properties(void *data)
 {
-    UNUSED_PARAMETER(data);
+    struct zoom_filter *filter = data;
     obs_properties_t *props = obs_properties_create();
 
     // 1. 基本设置组
@@ -137,6 +279,19 @@ obs_properties_t *zoom_filter_get_properties(void *data)
     obs_properties_add_float_slider(basic_group, S_SCALE_FACTOR, 
         obs_module_text("ScaleFactor"), 1.0, 5.0, 0.1);
     
+    // 链接组：同名的实例共享一个缩放控制器
+    obs_property_t *group_text = obs_properties_add_text(basic_group, S_ZOOM_GROUP,
+        obs_module_text("ZoomGroup"), OBS_TEXT_DEFAULT);
+    obs_property_set_long_description(group_text, obs_module_text("ZoomGroupDescription"));
+    
+    obs_property_t *render_list = obs_properties_add_list(basic_group, S_RENDER_MODE,
+        obs_module_text("RenderMode"),
+        OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(render_list, obs_module_text("RenderViewport"),
+        RENDER_MODE_VIEWPORT);
+    obs_property_list_add_int(render_list, obs_module_text("RenderMatrix"),
+        RENDER_MODE_MATRIX);
+    
     obs_property_t *tracking_list = obs_properties_add_list(basic_group, S_TRACKING_MODE,
         obs_module_text("MouseTrackingMode"),
         OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
@@ -146,6 +301,14 @@ obs_properties_t *zoom_filter_get_properties(void *data)
         TRACKING_MODE_REALTIME);
     obs_property_list_add_int(tracking_list, obs_module_text("TrackingZooming"), 
         TRACKING_MODE_ZOOMING);
+    obs_property_list_add_int(tracking_list, obs_module_text("TrackingActivity"),
+        TRACKING_MODE_ACTIVITY);
+    
+    // 自动取景（活动跟踪模式）参数
+    obs_properties_add_int_slider(basic_group, S_ACTIVITY_INTERVAL,
+        obs_module_text("ActivityInterval"), 33, 1000, 1);
+    obs_properties_add_int_slider(basic_group, S_ACTIVITY_DOWNSCALE,
+        obs_module_text("ActivityDownscale"), 2, 32, 1);
     
     // 添加鼠标跟踪平滑度控制
     obs_properties_t *tracking_smooth_group = obs_properties_create();
@@ -156,6 +319,27 @@ obs_properties_t *zoom_filter_get_properties(void *data)
         obs_module_text("TrackingSmoothSettings"),
         OBS_GROUP_CHECKABLE, tracking_smooth_group);
     
+    // 死区和停稳阈值（消除光标微小抖动）
+    obs_properties_add_int_slider(basic_group, S_DEAD_ZONE_WIDTH,
+        obs_module_text("DeadZoneWidth"), 0, 90, 1);
+    obs_properties_add_int_slider(basic_group, S_DEAD_ZONE_HEIGHT,
+        obs_module_text("DeadZoneHeight"), 0, 90, 1);
+    obs_properties_add_float_slider(basic_group, S_SETTLE_THRESHOLD,
+        obs_module_text("SettleThreshold"), 0.0, 5.0, 0.1);
+    
+    // 添加光标预测控制
+    obs_property_t *predict_list = obs_properties_add_list(basic_group, S_PREDICT_MODE,
+        obs_module_text("PredictMode"),
+        OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(predict_list, obs_module_text("PredictNone"),
+        PREDICT_MODE_NONE);
+    obs_property_list_add_int(predict_list, obs_module_text("PredictVelocity"),
+        PREDICT_MODE_VELOCITY);
+    obs_property_list_add_int(predict_list, obs_module_text("PredictKalman"),
+        PREDICT_MODE_KALMAN);
+    obs_properties_add_int_slider(basic_group, S_PREDICT_HORIZON,
+        obs_module_text("PredictHorizon"), 0, 100, 1);
+    
     obs_properties_add_group(props, "basic_settings", 
         obs_module_text("BasicSettings"),
         OBS_GROUP_NORMAL, basic_group);
@@ -166,46 +350,73 @@ obs_properties_t *zoom_filter_get_properties(void *data)
         obs_module_text("ZoomStepSettings"),
         OBS_GROUP_NORMAL, step_group);
 
-    // 3. 平滑过渡组 (可勾选)
+    // 3. 滚轮和捏合缩放组 (可勾选)
+    obs_properties_t *gesture_group = add_gesture_group(props);
+    obs_properties_add_group(props, S_GESTURE_ZOOM,
+        obs_module_text("GestureSettings"),
+        OBS_GROUP_CHECKABLE, gesture_group);
+
+    // 4. 平滑过渡组 (可勾选)
     obs_properties_t *smooth_group = add_smooth_group(props);
     obs_properties_add_group(props, S_SMOOTH_ENABLED, 
         obs_module_text("SmoothSettings"),
         OBS_GROUP_CHECKABLE, smooth_group);
 
-    // 4. 时间控制组
+    // 5. 时间控制组
     obs_properties_t *time_group = add_time_control_group(props);
     obs_properties_add_group(props, "time_control_settings", 
         obs_module_text("TimeControlSettings"),
         OBS_GROUP_NORMAL, time_group);
 
-<<<<<<< HEAD
-    // 5. 支持开发者组
+    // 6. 轨迹录制组
+    obs_properties_t *record_group = add_record_group(props);
+    obs_properties_add_group(props, "record_settings",
+        obs_module_text("RecordSettings"),
+        OBS_GROUP_NORMAL, record_group);
+
+    // 7. 脚本时间轴组
+    obs_properties_t *timeline_group = add_timeline_group(props);
+    obs_properties_add_group(props, "timeline_settings",
+        obs_module_text("TimelineSettings"),
+        OBS_GROUP_NORMAL, timeline_group);
+
+    // 8. 诊断组（只读，仅在有滤镜实例时显示）
+    if (filter) {
+        obs_properties_t *diag_group = add_diagnostics_group(filter);
+        obs_properties_add_group(props, S_DIAGNOSTICS,
+            obs_module_text("Diagnostics"),
+            OBS_GROUP_NORMAL, diag_group);
+    }
+
+    // 9. 支持开发者组
     obs_properties_t *support_group = add_support_group(props);
     obs_properties_add_group(props, "support_settings", 
         obs_module_text("SupportDeveloper"),
         OBS_GROUP_NORMAL, support_group);
 
-=======
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
     return props;
 }
 
 void zoom_filter_get_defaults(obs_data_t *settings)
 {
     obs_data_set_default_double(settings, S_SCALE_FACTOR, 1.0);
-<<<<<<< HEAD
+    obs_data_set_default_string(settings, S_ZOOM_GROUP, "");
     obs_data_set_default_int(settings, S_TRACKING_MODE, TRACKING_MODE_REALTIME);
-=======
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
+    obs_data_set_default_int(settings, S_RENDER_MODE, RENDER_MODE_MATRIX);
     obs_data_set_default_double(settings, S_SINGLE_STEP, 0.1);
-    obs_data_set_default_double(settings, S_CONT_STEP, 0.01);
+    obs_data_set_default_double(settings, S_ZOOM_RATE, 1.0);
+    obs_data_set_default_bool(settings, S_ZOOM_RATE_RELATIVE, true);
+    obs_data_set_default_int(settings, S_ZOOM_RAMP, 250);
+    obs_data_set_default_bool(settings, S_GESTURE_ZOOM, false);
+    obs_data_set_default_int(settings, S_WHEEL_MODIFIER, CURSOR_MOD_CTRL);
+    obs_data_set_default_int(settings, S_WHEEL_STEP, 10);
     obs_data_set_default_bool(settings, S_SMOOTH_ENABLED, true);
     obs_data_set_default_double(settings, S_SMOOTHNESS, 0.6);
     obs_data_set_default_int(settings, S_SMOOTH_MODE, SMOOTH_MODE_EXPONENTIAL);
     obs_data_set_default_int(settings, S_RESPONSE_TIME, 50);
     obs_data_set_default_int(settings, S_ANIM_TIME, 400);
     obs_data_set_default_int(settings, S_AUTO_RESET, 0);
-<<<<<<< HEAD
+    obs_data_set_default_bool(settings, S_MIDFRAME_EVAL, false);
     
     // 新增平滑控制参数的默认值
     obs_data_set_default_double(settings, S_START_SPEED, 1.0);
@@ -215,6 +426,18 @@ void zoom_filter_get_defaults(obs_data_t *settings)
     // 鼠标跟踪平滑度默认值
     obs_data_set_default_bool(settings, S_TRACKING_SMOOTH_ENABLED, true);
     obs_data_set_default_double(settings, S_TRACKING_SMOOTHNESS, 0.6);
-=======
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
+    obs_data_set_default_int(settings, S_DEAD_ZONE_WIDTH, 0);
+    obs_data_set_default_int(settings, S_DEAD_ZONE_HEIGHT, 0);
+    obs_data_set_default_double(settings, S_SETTLE_THRESHOLD, 0.5);
+    
+    // 光标预测默认值
+    obs_data_set_default_int(settings, S_PREDICT_MODE, PREDICT_MODE_NONE);
+    obs_data_set_default_int(settings, S_PREDICT_HORIZON, 16);
+    
+    // 自动取景默认值
+    obs_data_set_default_int(settings, S_ACTIVITY_INTERVAL, 100);
+    obs_data_set_default_int(settings, S_ACTIVITY_DOWNSCALE, 8);
+    
+    // 轨迹录制默认关闭
+    obs_data_set_default_int(settings, S_RECORD_MODE, RECORD_MODE_OFF);
 }
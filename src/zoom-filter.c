@@ -1,78 +1,440 @@
 #include <obs-module.h>
 #include <util/platform.h>
+#include <util/threading.h>
+#include <util/profiler.h>
 #include <math.h>
+#include <string.h>
 #include "plugin-support.h"
 #include "zoom-filter.h"
+#include "zoom-mapping.h"
+#include "zoom-script.h"
+
+static const char *tick_name = "zoom_filter_video_tick";
+static const char *update_name = "zoom_update";
+static const char *tracking_name = "tracking_update_mouse";
+static const char *smoothing_name = "smoothing_update";
+static const char *render_name = "rendering_render";
+static const char *activity_name = "activity_capture";
 
-<<<<<<< HEAD
-=======
-#define S_SCALE_FACTOR "scale_factor"
-#define S_SINGLE_STEP "single_click_step"
-#define S_CONT_STEP "continuous_step"
-#define S_SMOOTH_ENABLED "smooth_enabled"
-#define S_SMOOTHNESS "smoothness"
-#define S_SMOOTH_MODE "smoothing_mode"
-#define S_RESPONSE_TIME "response_time"
-#define S_ANIM_TIME "animation_time"
-#define S_AUTO_RESET "auto_reset_time"
-
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
 static const char *zoom_filter_get_name(void *unused)
 {
     UNUSED_PARAMETER(unused);
     return obs_module_text("ZoomFilter");
 }
 
-<<<<<<< HEAD
-=======
-static float calculate_smooth_scale(struct zoom_filter *filter, uint64_t current_time)
+// float按位存入long，在线程之间原子传递
+static long scale_to_bits(float scale)
+{
+    union { float f; int32_t i; } bits = {.f = scale};
+    return (long)bits.i;
+}
+
+static float bits_to_scale(long value)
+{
+    union { float f; int32_t i; } bits = {.i = (int32_t)value};
+    return bits.f;
+}
+
+// 平滑参数变化后重建缓动曲线查找表
+static void rebuild_curve(struct smoothing_data *smoothing)
+{
+    if (smoothing_rebuild_curve(smoothing)) {
+        obs_log(LOG_DEBUG, "Curve table rebuilt (mode %d), max error %.2e",
+                smoothing->mode, smoothing->curve_error);
+    }
+}
+
+// 读取自动取景相关设置，工作线程只按设置启停（只在设置线程启动或等待线程）；
+// 本实例不模拟控制器时渲染线程不读回画面，工作线程空闲等待
+static void update_activity(struct zoom_filter *filter, obs_data_t *settings)
+{
+    filter->activity.interval = obs_data_get_int(settings, S_ACTIVITY_INTERVAL) * 1000000; // ms to ns
+    filter->activity.downscale = (uint32_t)obs_data_get_int(settings, S_ACTIVITY_DOWNSCALE);
+    activity_set_enabled(&filter->activity,
+                         obs_data_get_int(settings, S_TRACKING_MODE) == TRACKING_MODE_ACTIVITY);
+}
+
+// 停止录制（写完剩余记录）并解除回放文件映射；会等待写入线程，不在渲染线程调用
+static void free_record_session(void *data)
+{
+    struct record_session *session = data;
+    
+    if (!session)
+        return;
+    recorder_stop(&session->recorder);
+    replay_file_close(&session->replay_file);
+    bfree(session);
+}
+
+static void free_timeline(struct timeline_data *timeline)
+{
+    if (!timeline)
+        return;
+    timeline_free(timeline);
+    bfree(timeline);
+}
+
+// 切换轨迹录制/回放，只有模式或文件变化时才重新开始，调整其他设置不会打断录制。
+// 新会话在这里打开，渲染线程下一帧换用
+static void update_record(struct zoom_filter *filter, obs_data_t *settings)
+{
+    int setting = (int)obs_data_get_int(settings, S_RECORD_MODE);
+    const char *path = obs_data_get_string(settings,
+        setting == RECORD_MODE_REPLAY ? S_REPLAY_PATH : S_RECORD_PATH);
+    struct record_session *session = NULL;
+    
+    if (setting == filter->record_setting && filter->record_path &&
+        strcmp(path, filter->record_path) == 0)
+        return;
+    
+    // 渲染线程可能还在读取回放文件的映射，覆盖同一个文件会使映射失效
+    bool replaying_path = filter->record_setting == RECORD_MODE_REPLAY &&
+                          filter->record_path && strcmp(path, filter->record_path) == 0;
+    
+    bfree(filter->record_path);
+    filter->record_path = bstrdup(path);
+    filter->record_setting = setting;
+    
+    if (setting == RECORD_MODE_RECORD && replaying_path) {
+        obs_log(LOG_WARNING, "'%s' is being replayed, choose another file to record", path);
+    } else if (setting == RECORD_MODE_RECORD) {
+        session = bzalloc(sizeof(*session));
+        if (recorder_start(&session->recorder, path, obs_get_frame_interval_ns(),
+                           obs_get_video_frame_time())) {
+            session->mode = RECORD_MODE_RECORD;
+        } else {
+            free_record_session(session);
+            session = NULL;
+        }
+    } else if (setting == RECORD_MODE_REPLAY && *path) {
+        // 回放从下一帧开始（replay.start为0时由第一次查找设置）
+        session = bzalloc(sizeof(*session));
+        if (replay_file_open(&session->replay_file, path) &&
+            replay_attach(&session->replay, session->replay_file.data,
+                          session->replay_file.size)) {
+            session->mode = RECORD_MODE_REPLAY;
+            obs_log(LOG_INFO, "Replaying %zu frames from '%s'", session->replay.count, path);
+        } else {
+            free_record_session(session);
+            session = NULL;
+            obs_log(LOG_WARNING, "'%s' is not a valid zoom trajectory log", path);
+        }
+    }
+    
+    // 上一个会话还没被渲染线程取走时直接在这里关闭
+    free_record_session(mailbox_post(&filter->record_box, session));
+}
+
+// 脚本文件变化时重新加载和编译，渲染线程下一帧换用并从头播放
+static void update_timeline(struct zoom_filter *filter, obs_data_t *settings)
+{
+    const char *path = obs_data_get_string(settings, S_TIMELINE_PATH);
+    
+    if (filter->timeline_path && strcmp(path, filter->timeline_path) == 0)
+        return;
+    
+    bfree(filter->timeline_path);
+    filter->timeline_path = bstrdup(path);
+    
+    struct timeline_data *loaded = bzalloc(sizeof(*loaded));
+    if (*path && !script_load_timeline(path, loaded)) {
+        obs_log(LOG_WARNING, "Zoom timeline '%s' not loaded", path);
+    }
+    free_timeline(mailbox_post(&filter->timeline_box, loaded));
+}
+
+void zoom_filter_restart_timeline(struct zoom_filter *filter)
 {
-    if (!filter->smooth_enabled || filter->animation_time == 0)
-        return filter->target_scale;
+    os_atomic_set_bool(&filter->timeline_restart, true);
+}
 
-    float t = (float)(current_time - filter->transition_start) / (float)filter->animation_time;
-    if (t >= 1.0f) {
-        filter->scale = filter->target_scale;
-        return filter->target_scale;
+// 换用设置线程发布的录制/回放会话（仅渲染线程调用）。换下的会话交给销毁线程关闭，
+// 渲染线程不等待写入线程，也不解除文件映射
+static void refresh_record(struct zoom_filter *filter)
+{
+    void *session;
+    
+    if (!mailbox_take(&filter->record_box, &session))
+        return;
+    if (filter->record) {
+        obs_queue_task(OBS_TASK_DESTROY, free_record_session, filter->record, false);
     }
+    filter->record = session;
+    filter->record_noted = false;
+}
 
-    float start_scale = filter->scale;
-    float end_scale = filter->target_scale;
-    float diff = end_scale - start_scale;
+// 换用新编译的时间轴，或按请求从头播放（仅渲染线程调用）
+static void refresh_timeline(struct zoom_filter *filter)
+{
+    void *timeline;
+    
+    if (mailbox_take(&filter->timeline_box, &timeline)) {
+        free_timeline(filter->timeline);
+        filter->timeline = timeline;
+        filter->timeline_start = 0;
+        filter->timeline_ended = false;
+    }
+    if (os_atomic_load_bool(&filter->timeline_restart) &&
+        os_atomic_exchange_bool(&filter->timeline_restart, false)) {
+        filter->timeline_start = 0;
+        filter->timeline_ended = false;
+    }
+}
 
-    // 防止震荡
-    if (fabsf(diff) < 0.001f)
-        return end_scale;
+// 回放或脚本控制中心时，中心由调用方设置（仅渲染线程和创建时调用）
+static bool external_center(const struct zoom_filter *filter)
+{
+    return (filter->record && filter->record->mode == RECORD_MODE_REPLAY) ||
+           (filter->timeline && filter->timeline->has_center);
+}
 
-    switch (filter->smoothing_mode) {
-    case SMOOTH_MODE_LINEAR:
-        return start_scale + diff * t;
-    case SMOOTH_MODE_EXPONENTIAL:
-        return start_scale + diff * (1.0f - expf(-t * (1.0f / filter->smoothness)));
-    case SMOOTH_MODE_LOGARITHMIC:
-        return start_scale + diff * (logf(1.0f + t * 9.0f) / logf(10.0f));
-    default:
-        return filter->target_scale;
+// 读取设置到一份新的参数（设置线程）。缓动曲线表也在这里建好，渲染线程只复制
+static struct zoom_params *read_params(struct zoom_filter *filter, obs_data_t *settings)
+{
+    struct zoom_params *params = bzalloc(sizeof(*params));
+    
+    params->tracking_mode = (int)obs_data_get_int(settings, S_TRACKING_MODE);
+    params->tracking_smooth = obs_data_get_bool(settings, S_TRACKING_SMOOTH_ENABLED);
+    params->tracking_smoothness = (float)obs_data_get_double(settings, S_TRACKING_SMOOTHNESS);
+    params->dead_zone_x = (float)obs_data_get_int(settings, S_DEAD_ZONE_WIDTH) / 100.0f;
+    params->dead_zone_y = (float)obs_data_get_int(settings, S_DEAD_ZONE_HEIGHT) / 100.0f;
+    params->settle_threshold = (float)obs_data_get_double(settings, S_SETTLE_THRESHOLD);
+    params->predict_mode = (int)obs_data_get_int(settings, S_PREDICT_MODE);
+    params->predict_horizon = (int)obs_data_get_int(settings, S_PREDICT_HORIZON);
+    
+    filter->curve.enabled = obs_data_get_bool(settings, S_SMOOTH_ENABLED);
+    filter->curve.smoothness = (float)obs_data_get_double(settings, S_SMOOTHNESS);
+    filter->curve.mode = (int)obs_data_get_int(settings, S_SMOOTH_MODE);
+    filter->curve.animation_time = obs_data_get_int(settings, S_ANIM_TIME) * 1000000; // ms to ns
+    filter->curve.start_speed = (float)obs_data_get_double(settings, S_START_SPEED);
+    filter->curve.end_deceleration = (float)obs_data_get_double(settings, S_END_DECEL);
+    filter->curve.overshoot = (float)obs_data_get_double(settings, S_OVERSHOOT);
+    filter->curve.rate = (float)obs_data_get_double(settings, S_ZOOM_RATE);
+    filter->curve.rate_relative = obs_data_get_bool(settings, S_ZOOM_RATE_RELATIVE);
+    filter->curve.rate_ramp = obs_data_get_int(settings, S_ZOOM_RAMP) * 1000000; // ms to ns
+    rebuild_curve(&filter->curve);
+    params->smoothing = filter->curve;
+    
+    params->render_mode = (int)obs_data_get_int(settings, S_RENDER_MODE);
+    params->midframe_eval = obs_data_get_bool(settings, S_MIDFRAME_EVAL);
+    params->gesture_enabled = obs_data_get_bool(settings, S_GESTURE_ZOOM);
+    int modifier = (int)obs_data_get_int(settings, S_WHEEL_MODIFIER);
+    params->wheel_modifier = modifier >= 0 && modifier < CURSOR_MOD_COUNT ? modifier
+                                                                         : CURSOR_MOD_CTRL;
+    params->wheel_step = (float)obs_data_get_int(settings, S_WHEEL_STEP) / 100.0f;
+    
+    params->single_click_step = (float)obs_data_get_double(settings, S_SINGLE_STEP);
+    params->response_time = obs_data_get_int(settings, S_RESPONSE_TIME) * 1000000; // ms to ns
+    params->auto_reset_time = obs_data_get_int(settings, S_AUTO_RESET) * 1000000; // ms to ns
+    
+    // 与上次写入/读取的值比较，尚未写回的运行时缩放不会被设置中的旧值覆盖
+    params->scale = (float)(double)obs_data_get_double(settings, S_SCALE_FACTOR);
+    pthread_mutex_lock(&filter->settings_mutex);
+    if (params->scale != filter->saved_scale) {
+        filter->saved_scale = params->scale;
+        filter->scale_serial++;
     }
+    params->scale_serial = filter->scale_serial;
+    pthread_mutex_unlock(&filter->settings_mutex);
+    return params;
+}
+
+// 跟踪和平滑参数写入控制器（仅渲染线程）；链接组时只有组长的设置生效
+static void apply_controller(struct zoom_controller *ctl, const struct zoom_params *params)
+{
+    ctl->tracking.smooth_enabled = params->tracking_smooth;
+    ctl->tracking.smoothness = params->tracking_smoothness;
+    ctl->tracking.dead_zone_x = params->dead_zone_x;
+    ctl->tracking.dead_zone_y = params->dead_zone_y;
+    ctl->tracking.settle_threshold = params->settle_threshold;
+    tracking_set_prediction(&ctl->tracking, params->predict_mode, params->predict_horizon);
+    mapping_invalidate(&ctl->tracking.mapping);
+    
+    smoothing_copy_settings(&ctl->smoothing, &params->smoothing);
+}
+
+// 回放或脚本控制中心时由调用方设置位置，设置中的跟踪模式暂不生效
+static int effective_tracking_mode(const struct zoom_filter *filter, bool external)
+{
+    return external ? TRACKING_MODE_EXTERNAL : filter->params->tracking_mode;
+}
+
+// 按需读取延迟统计：proc_handler_call(ph, "get_latency_stats", cd)
+static void zoom_filter_get_latency_stats(void *data, calldata_t *cd)
+{
+    struct zoom_filter *filter = data;
+    char text[STATS_TEXT_SIZE];
+    
+    stats_format(&filter->stats, text, sizeof(text));
+    calldata_set_string(cd, "stats", text);
+}
+
+// 程序控制（脚本、外部自动化）：命令直接进入控制器的队列，不经过 obs_source_update，
+// 可以高频调用。queued为false表示参数无效或队列已满
+//   zoom_to(scale, x, y, duration_ms)：x/y省略或为负数时不平移，duration_ms省略或为负数时使用设置中的动画时长
+//   zoom_by(delta)：在当前目标缩放值上增减
+//   pan_to(x, y)：平移到源内相对坐标(0-1)并保持，为负数时恢复按跟踪模式移动
+static void submit_proc_command(struct zoom_filter *filter, calldata_t *cd,
+                                struct zoom_command *command)
+{
+    command->timestamp = os_gettime_ns();
+    calldata_set_bool(cd, "queued", group_link_submit(&filter->link, command));
+}
+
+static void zoom_filter_proc_zoom_to(void *data, calldata_t *cd)
+{
+    struct zoom_command command = {
+        .type = ZOOM_CMD_ZOOM_TO,
+        .x = -1.0f,
+        .y = -1.0f,
+        .duration = -1,
+    };
+    double scale, x, y;
+    long long duration;
+    
+    if (!calldata_get_float(cd, "scale", &scale) || !isfinite(scale)) {
+        calldata_set_bool(cd, "queued", false);
+        return;
+    }
+    command.scale = (float)scale;
+    if (calldata_get_float(cd, "x", &x) && calldata_get_float(cd, "y", &y)) {
+        command.x = (float)x;
+        command.y = (float)y;
+    }
+    if (calldata_get_int(cd, "duration_ms", &duration) && duration >= 0) {
+        command.duration = (int64_t)duration * 1000000; // ms to ns
+    }
+    submit_proc_command(data, cd, &command);
+}
+
+static void zoom_filter_proc_zoom_by(void *data, calldata_t *cd)
+{
+    struct zoom_command command = {.type = ZOOM_CMD_ZOOM_BY};
+    double delta;
+    
+    if (!calldata_get_float(cd, "delta", &delta) || !isfinite(delta)) {
+        calldata_set_bool(cd, "queued", false);
+        return;
+    }
+    command.scale = (float)delta;
+    submit_proc_command(data, cd, &command);
+}
+
+static void zoom_filter_proc_pan_to(void *data, calldata_t *cd)
+{
+    struct zoom_command command = {.type = ZOOM_CMD_PAN_TO};
+    double x, y;
+    
+    if (!calldata_get_float(cd, "x", &x) || !calldata_get_float(cd, "y", &y) ||
+        isnan(x) || isnan(y)) {
+        calldata_set_bool(cd, "queued", false);
+        return;
+    }
+    command.x = (float)x;
+    command.y = (float)y;
+    submit_proc_command(data, cd, &command);
+}
+
+// 供诊断面板和get_state读取的模拟结果（仅渲染线程调用，每帧一次）
+static void publish_scale(struct zoom_filter *filter, const struct zoom_controller *ctl)
+{
+    struct zoom_state_snapshot *state = &filter->state;
+    float x, y;
+    
+    tracking_get_center(&ctl->tracking, 1.0f, 1.0f, &x, &y);
+    os_atomic_inc_long(&state->seq);
+    os_atomic_set_long(&state->scale, scale_to_bits(ctl->smoothing.current_scale));
+    os_atomic_set_long(&state->target_scale, scale_to_bits(ctl->smoothing.target_scale));
+    os_atomic_set_long(&state->center_x, scale_to_bits(x));
+    os_atomic_set_long(&state->center_y, scale_to_bits(y));
+    os_atomic_set_long(&state->panning, ctl->tracking.pan_active);
+    os_atomic_inc_long(&state->seq);
+    
+    os_atomic_set_long(&filter->stats.live.current_scale,
+                       lroundf(ctl->smoothing.current_scale * 1000.0f));
+    os_atomic_set_long(&filter->stats.live.target_scale,
+                       lroundf(ctl->smoothing.target_scale * 1000.0f));
+}
+
+// 读取当前状态：缩放值、目标缩放值、中心（源内相对坐标）、是否由程序指定中心
+// 读取渲染线程发布的快照，不访问控制器；数值是最近一次模拟的结果，来自同一帧
+static void zoom_filter_proc_get_state(void *data, calldata_t *cd)
+{
+    struct zoom_filter *filter = data;
+    struct zoom_state_snapshot *state = &filter->state;
+    long seq, scale, target, x, y, panning;
+    
+    do {
+        seq = os_atomic_load_long(&state->seq);
+        scale = os_atomic_load_long(&state->scale);
+        target = os_atomic_load_long(&state->target_scale);
+        x = os_atomic_load_long(&state->center_x);
+        y = os_atomic_load_long(&state->center_y);
+        panning = os_atomic_load_long(&state->panning);
+    } while ((seq & 1) || os_atomic_load_long(&state->seq) != seq);
+    
+    calldata_set_float(cd, "scale", (double)bits_to_scale(scale));
+    calldata_set_float(cd, "target_scale", (double)bits_to_scale(target));
+    calldata_set_float(cd, "x", (double)bits_to_scale(x));
+    calldata_set_float(cd, "y", (double)bits_to_scale(y));
+    calldata_set_bool(cd, "panning", panning != 0);
 }
 
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
 static void *zoom_filter_create(obs_data_t *settings, obs_source_t *source)
 {
     struct zoom_filter *filter = bzalloc(sizeof(struct zoom_filter));
     filter->context = source;
     
-    // 初始化各个模块
-    tracking_init(&filter->tracking);
-    smoothing_init(&filter->smoothing);
-    rendering_init(&filter->rendering, &filter->tracking, &filter->smoothing);
+    // 初始化各个模块（先使用自己的控制器，第一帧再加入设置中的组）
+    group_link_init(&filter->link);
+    filter->leading = true;
+    struct zoom_controller *ctl = filter->link.controller;
+    stats_init(&filter->stats);
+    rendering_init(&filter->rendering, source, &ctl->tracking, &ctl->smoothing,
+                   &filter->stats);
+    if (!activity_init(&filter->activity)) {
+        obs_log(LOG_ERROR, "Failed to initialize activity detection");
+    }
     
-    // 设置初始值
-    filter->tracking.mode = (int)obs_data_get_int(settings, S_TRACKING_MODE);
-    filter->tracking.smooth_enabled = obs_data_get_bool(settings, S_TRACKING_SMOOTH_ENABLED);
-    filter->tracking.smoothness = (float)obs_data_get_double(settings, S_TRACKING_SMOOTHNESS);
-    filter->smoothing.current_scale = (float)(double)obs_data_get_double(settings, S_SCALE_FACTOR);
-    filter->smoothing.target_scale = filter->smoothing.current_scale;
+    pthread_mutex_init(&filter->settings_mutex, NULL);
+    mailbox_init(&filter->record_box);
+    mailbox_init(&filter->timeline_box);
+    filter->record_setting = RECORD_MODE_OFF;
+    
+    proc_handler_t *ph = obs_source_get_proc_handler(source);
+    proc_handler_add(ph, "void get_latency_stats(out string stats)",
+                     zoom_filter_get_latency_stats, filter);
+    proc_handler_add(ph, "void zoom_to(in float scale, in float x, in float y, "
+                     "in int duration_ms, out bool queued)",
+                     zoom_filter_proc_zoom_to, filter);
+    proc_handler_add(ph, "void zoom_by(in float delta, out bool queued)",
+                     zoom_filter_proc_zoom_by, filter);
+    proc_handler_add(ph, "void pan_to(in float x, in float y, out bool queued)",
+                     zoom_filter_proc_pan_to, filter);
+    proc_handler_add(ph, "void get_state(out float scale, out float target_scale, "
+                     "out float x, out float y, out bool panning)",
+                     zoom_filter_proc_get_state, filter);
+    
+    // 设置初始值（渲染线程尚未开始，直接写入控制器）
+    group_link_request(&filter->link, obs_data_get_string(settings, S_ZOOM_GROUP));
+    update_record(filter, settings);
+    update_timeline(filter, settings);
+    refresh_record(filter);
+    refresh_timeline(filter);
+    update_activity(filter, settings);
+    ctl->smoothing.current_scale = (float)(double)obs_data_get_double(settings, S_SCALE_FACTOR);
+    ctl->smoothing.target_scale = ctl->smoothing.current_scale;
+    ctl->last_scale = ctl->smoothing.current_scale;
+    filter->saved_scale = ctl->smoothing.current_scale;
+    filter->saved_serial = ctl->scale_serial;
+    
+    mailbox_init(&filter->params_box);
+    smoothing_init(&filter->curve);
+    filter->params = read_params(filter, settings);
+    apply_controller(ctl, filter->params);
+    tracking_set_mode(&ctl->tracking, effective_tracking_mode(filter, external_center(filter)));
+    filter->rendering.mode = filter->params->render_mode;
+    publish_scale(filter, ctl);
     
     // 初始化热键
     filter->zoom_in_hotkey = obs_hotkey_register_frontend(
@@ -81,30 +443,8 @@ static void *zoom_filter_create(obs_data_t *settings, obs_source_t *source)
         "zoom_filter.zoom_out.global", obs_module_text("ZoomOut"), zoom_out, filter);
     filter->zoom_reset_hotkey = obs_hotkey_register_frontend(
         "zoom_filter.zoom_reset.global", obs_module_text("ZoomReset"), zoom_reset, filter);
-    
-    // 初始化长按支持
-    filter->zoom_in_pressed = false;
-    filter->zoom_out_pressed = false;
     filter->zoom_in_key = NULL;
     filter->zoom_out_key = NULL;
-    filter->last_zoom_time = 0;
-
-    // 初始化缩放控制参数
-    filter->single_click_step = (float)obs_data_get_double(settings, S_SINGLE_STEP);
-    filter->continuous_step = (float)obs_data_get_double(settings, S_CONT_STEP);
-    filter->response_time = obs_data_get_int(settings, S_RESPONSE_TIME) * 1000000; // ms to ns
-    filter->auto_reset_time = obs_data_get_int(settings, S_AUTO_RESET) * 1000000; // ms to ns
-    
-    // 平滑相关参数
-    filter->smoothing.enabled = obs_data_get_bool(settings, S_SMOOTH_ENABLED);
-    filter->smoothing.smoothness = (float)obs_data_get_double(settings, S_SMOOTHNESS);
-    filter->smoothing.mode = (int)obs_data_get_int(settings, S_SMOOTH_MODE);
-    filter->smoothing.animation_time = obs_data_get_int(settings, S_ANIM_TIME) * 1000000; // ms to ns
-    
-    // 新增的平滑控制参数
-    filter->smoothing.start_speed = (float)obs_data_get_double(settings, S_START_SPEED);
-    filter->smoothing.end_deceleration = (float)obs_data_get_double(settings, S_END_DECEL);
-    filter->smoothing.overshoot = (float)obs_data_get_double(settings, S_OVERSHOOT);
     
     return filter;
 }
@@ -112,12 +452,50 @@ static void *zoom_filter_create(obs_data_t *settings, obs_source_t *source)
 static void zoom_filter_destroy(void *data)
 {
     struct zoom_filter *filter = data;
+    struct zoom_controller *ctl = filter->link.controller;
     
     // 注销热键
     obs_hotkey_unregister(filter->zoom_in_hotkey);
     obs_hotkey_unregister(filter->zoom_out_hotkey);
     obs_hotkey_unregister(filter->zoom_reset_hotkey);
     
+    // 输出预测误差统计，便于按部署环境调整预测时长
+    float error_mean, error_max;
+    if (filter->leading &&
+        tracking_get_prediction_error(&ctl->tracking, &error_mean, &error_max)) {
+        obs_log(LOG_INFO, "Cursor prediction error: mean %.1f px, max %.1f px (%llu samples)",
+                error_mean, error_max,
+                (unsigned long long)ctl->tracking.predict_checked);
+    }
+    
+    obs_log(LOG_INFO, "Render paths: %ld identity frames, %ld transform frames",
+            os_atomic_load_long(&filter->stats.live.identity_frames),
+            os_atomic_load_long(&filter->stats.live.transform_frames));
+    
+    char stats_text[STATS_TEXT_SIZE];
+    stats_format(&filter->stats, stats_text, sizeof(stats_text));
+    if (stats_text[0]) {
+        obs_log(LOG_INFO, "Latency percentiles:\n%s", stats_text);
+    }
+    
+    // 停止录制（写完剩余记录）并解除回放文件映射
+    free_record_session(filter->record);
+    free_record_session(mailbox_drain(&filter->record_box));
+    bfree(filter->record_path);
+    free_timeline(filter->timeline);
+    free_timeline(mailbox_drain(&filter->timeline_box));
+    bfree(filter->timeline_path);
+    
+    // 停止活动检测线程，离开所在的组（释放光标后端引用）
+    if (filter->gesture_acquired) {
+        cursor_sampler_release();
+    }
+    activity_free(&filter->activity);
+    group_link_free(&filter->link);
+    bfree(mailbox_drain(&filter->params_box));
+    bfree(filter->params);
+    pthread_mutex_destroy(&filter->settings_mutex);
+    
     // 释放内存
     bfree(filter);
 }
@@ -125,179 +503,619 @@ static void zoom_filter_destroy(void *data)
 static void zoom_filter_update(void *data, obs_data_t *settings)
 {
     struct zoom_filter *filter = data;
-<<<<<<< HEAD
-    float old_scale = filter->smoothing.current_scale;
-=======
-    float old_scale = filter->scale;
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
     
-    // 更新跟踪模式和平滑度
-    filter->tracking.mode = (int)obs_data_get_int(settings, S_TRACKING_MODE);
-    filter->tracking.smooth_enabled = obs_data_get_bool(settings, S_TRACKING_SMOOTH_ENABLED);
-    filter->tracking.smoothness = (float)obs_data_get_double(settings, S_TRACKING_SMOOTHNESS);
+    // 录制/回放、脚本和自动取景需要打开文件或启停线程，只在设置线程处理；
+    // 组名变化在下一帧生效
+    group_link_request(&filter->link, obs_data_get_string(settings, S_ZOOM_GROUP));
+    update_record(filter, settings);
+    update_timeline(filter, settings);
+    update_activity(filter, settings);
     
-    // 更新平滑设置
-    filter->smoothing.enabled = obs_data_get_bool(settings, S_SMOOTH_ENABLED);
-    filter->smoothing.smoothness = (float)obs_data_get_double(settings, S_SMOOTHNESS);
-    filter->smoothing.mode = (int)obs_data_get_int(settings, S_SMOOTH_MODE);
-    filter->smoothing.animation_time = obs_data_get_int(settings, S_ANIM_TIME) * 1000000;
+    // 其余参数整体交给渲染线程，下一帧开始时写入控制器；上一份还没被取走时直接替换
+    bfree(mailbox_post(&filter->params_box, read_params(filter, settings)));
+}
+
+// 把输入改变的目标缩放值写回设置，不触发 obs_source_update（UI线程或保存时调用，不在渲染线程）
+// 链接组时每个成员各自写回，保存后每个实例重新打开时都从同一个缩放值开始
+static void flush_scale(struct zoom_filter *filter, obs_data_t *settings)
+{
+    if (!os_atomic_exchange_bool(&filter->scale_unsaved, false))
+        return;
     
-    // 更新新增的平滑控制参数
-    filter->smoothing.start_speed = (float)obs_data_get_double(settings, S_START_SPEED);
-    filter->smoothing.end_deceleration = (float)obs_data_get_double(settings, S_END_DECEL);
-    filter->smoothing.overshoot = (float)obs_data_get_double(settings, S_OVERSHOOT);
+    float scale = bits_to_scale(os_atomic_load_long(&filter->unsaved_scale));
+    pthread_mutex_lock(&filter->settings_mutex);
+    filter->saved_scale = scale;
+    obs_data_set_double(settings, S_SCALE_FACTOR, (double)scale);
+    pthread_mutex_unlock(&filter->settings_mutex);
+}
+
+// UI线程：滤镜仍然存在时写回（只持有弱引用，滤镜先被销毁时什么都不做）
+static void flush_scale_task(void *param)
+{
+    obs_weak_source_t *weak = param;
+    obs_source_t *source = obs_weak_source_get_source(weak);
     
-    // 更新缩放控制
-    filter->single_click_step = (float)obs_data_get_double(settings, S_SINGLE_STEP);
-    filter->continuous_step = (float)obs_data_get_double(settings, S_CONT_STEP);
-    filter->response_time = obs_data_get_int(settings, S_RESPONSE_TIME) * 1000000;
-    filter->auto_reset_time = obs_data_get_int(settings, S_AUTO_RESET) * 1000000;
+    obs_weak_source_release(weak);
+    if (!source)
+        return;
     
-    // 检查缩放值是否变化
-    float new_scale = (float)(double)obs_data_get_double(settings, S_SCALE_FACTOR);
-    if (new_scale != filter->smoothing.target_scale) {
-        smoothing_set_target(&filter->smoothing, new_scale, os_gettime_ns());
+    struct zoom_filter *filter = obs_obj_get_data(source);
+    if (filter) {
+        obs_data_t *settings = obs_source_get_settings(source);
+        flush_scale(filter, settings);
+        obs_data_release(settings);
     }
+    obs_source_release(source);
 }
 
-static void save_scale(struct zoom_filter *filter, float scale)
+static void queue_flush_scale(struct zoom_filter *filter)
 {
-    obs_data_t *settings = obs_source_get_settings(filter->context);
-    obs_data_set_double(settings, S_SCALE_FACTOR, (double)scale);
-    obs_source_update(filter->context, settings);
-    obs_data_release(settings);
+    obs_queue_task(OBS_TASK_UI, flush_scale_task,
+                   obs_source_get_weak_source(filter->context), false);
+}
+
+// 目标缩放值由输入改变后交给其他线程写回（仅渲染线程调用）：每次变化都更新待写回的值，
+// 停止变化一段时间后才请求UI线程写回，连续缩放期间不碰设置；保存场景集合时直接写回最新的值
+static void publish_unsaved_scale(struct zoom_filter *filter, uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    
+    if (filter->saved_serial != ctl->scale_serial) {
+        filter->saved_serial = ctl->scale_serial;
+        os_atomic_set_long(&filter->unsaved_scale, scale_to_bits(ctl->smoothing.target_scale));
+        os_atomic_set_bool(&filter->scale_unsaved, true);
+        filter->flush_pending = true;
+    }
+    if (filter->flush_pending && current_time - ctl->scale_changed >= SCALE_SAVE_DELAY) {
+        filter->flush_pending = false;
+        queue_flush_scale(filter);
+    }
+}
+
+// 目标缩放值由输入改变：只记录在内存中，稍后统一写回设置
+static void mark_scale_changed(struct zoom_controller *ctl, uint64_t current_time)
+{
+    ctl->scale_serial++;
+    ctl->scale_changed = current_time;
 }
 
-static void apply_zoom(struct zoom_filter *filter, float target)
+static void apply_zoom(struct zoom_filter *filter, float target, uint64_t current_time)
 {
+    struct zoom_controller *ctl = filter->link.controller;
+    float old_target = ctl->smoothing.target_scale;
+    
     // 限制缩放值范围
     target = (float)fmax(fmin((double)target, 5.0), 1.0);
     
-<<<<<<< HEAD
     // 设置新的目标缩放值
-    smoothing_set_target(&filter->smoothing, target, os_gettime_ns());
-    
-    // 保存到设置
-    save_scale(filter, target);
-=======
-    if (filter->smooth_enabled) {
-        if (fabs(target - filter->target_scale) > 0.001f) {
-            filter->target_scale = target;
-            filter->transition_start = os_gettime_ns();
-            save_scale(filter, target);
+    smoothing_set_target(&ctl->smoothing, target, current_time);
+    if (ctl->smoothing.target_scale != old_target) {
+        mark_scale_changed(ctl, current_time);
+    }
+}
+
+// 长按缩放：按住超过响应时间后，按设置的速度连续缩放（由平滑模块按实际帧间隔积分），
+// 整个长按是一段连续运动，不再每隔一段时间重新开始一次过渡
+static void update_held_zoom(struct zoom_filter *filter, uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    int direction = ctl->zoom_in_pressed ? 1 : ctl->zoom_out_pressed ? -1 : 0;
+    
+    // 响应时间只推迟开始，松开前一直按速度缩放
+    if (direction && !ctl->smoothing.rate_time &&
+        current_time - ctl->last_zoom_time <= filter->params->response_time) {
+        direction = 0;
+    }
+    
+    if (smoothing_update_rate(&ctl->smoothing, direction, 1.0f, 5.0f, current_time)) {
+        mark_scale_changed(ctl, current_time);
+        ctl->last_zoom_time = current_time;
+    }
+}
+
+// 程序控制的缩放：只改变运行时状态，不写回设置，高频调用也不会修改场景集合
+// duration为负数时使用设置中的动画时长
+static void apply_zoom_to(struct zoom_controller *ctl, float target, int64_t duration,
+                          uint64_t current_time)
+{
+    target = (float)fmax(fmin((double)target, 5.0), 1.0);
+    
+    if (duration < 0) {
+        smoothing_set_target(&ctl->smoothing, target, current_time);
+    } else {
+        smoothing_set_target_timed(&ctl->smoothing, target, current_time, (uint64_t)duration);
+    }
+    ctl->last_zoom_time = current_time;
+}
+
+// 按顺序执行热键和程序控制提交的命令（仅渲染线程调用）
+// 命令在当前帧的模拟时间生效，动画轨迹因此对齐到输出帧
+static void process_commands(struct zoom_filter *filter, uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    struct zoom_command command;
+    
+    while (command_queue_pop(&ctl->commands, &command)) {
+        float old_target = ctl->smoothing.target_scale;
+        float drawn_scale = ctl->smoothing.current_scale;
+        
+        switch (command.type) {
+            case ZOOM_CMD_IN:
+                ctl->frame_events |= command.pressed ? ZOOM_LOG_EVENT_IN_DOWN
+                                                        : ZOOM_LOG_EVENT_IN_UP;
+                ctl->zoom_in_pressed = command.pressed;
+                if (command.pressed) {
+                    apply_zoom(filter, ctl->smoothing.target_scale + filter->params->single_click_step,
+                               current_time);
+                    ctl->last_zoom_time = current_time;
+                }
+                break;
+            case ZOOM_CMD_OUT:
+                ctl->frame_events |= command.pressed ? ZOOM_LOG_EVENT_OUT_DOWN
+                                                        : ZOOM_LOG_EVENT_OUT_UP;
+                ctl->zoom_out_pressed = command.pressed;
+                if (command.pressed) {
+                    apply_zoom(filter, ctl->smoothing.target_scale - filter->params->single_click_step,
+                               current_time);
+                    ctl->last_zoom_time = current_time;
+                }
+                break;
+            case ZOOM_CMD_RESET:
+                ctl->frame_events |= ZOOM_LOG_EVENT_RESET;
+                apply_zoom(filter, 1.0f, current_time);
+                tracking_pan_to(&ctl->tracking, -1.0f, -1.0f);
+                ctl->last_zoom_time = current_time;
+                break;
+            case ZOOM_CMD_ZOOM_TO:
+                apply_zoom_to(ctl, command.scale, command.duration, current_time);
+                if (command.x >= 0.0f && command.y >= 0.0f) {
+                    tracking_pan_to(&ctl->tracking, command.x, command.y);
+                }
+                break;
+            case ZOOM_CMD_ZOOM_BY:
+                apply_zoom_to(ctl, ctl->smoothing.target_scale + command.scale, -1, current_time);
+                break;
+            case ZOOM_CMD_PAN_TO:
+                tracking_pan_to(&ctl->tracking, command.x, command.y);
+                break;
+            default:
+                break;
+        }
+        
+        // 从热键按下开始计时，到画面第一次变化为止
+        if (!filter->latency_pending && ctl->smoothing.target_scale != old_target) {
+            filter->latency_pending = true;
+            filter->latency_command_time = command.timestamp;
+            filter->latency_scale = drawn_scale;
+        }
+    }
+}
+
+// 丢弃热键命令（回放或脚本控制缩放期间）
+static void discard_commands(struct zoom_filter *filter)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    struct zoom_command command;
+    
+    while (command_queue_pop(&ctl->commands, &command)) {}
+    ctl->zoom_in_pressed = false;
+    ctl->zoom_out_pressed = false;
+}
+
+// 回放：丢弃实时输入，直接跳到录制的缩放值和中心
+static void apply_replay(struct zoom_filter *filter, uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    
+    discard_commands(filter);
+    
+    const struct zoom_log_record *record = replay_lookup(&filter->record->replay, current_time);
+    if (record) {
+        smoothing_jump_to(&ctl->smoothing, record->scale);
+        tracking_set_position(&ctl->tracking, record->center_x, record->center_y);
+    }
+}
+
+// 脚本时间轴：播放期间丢弃实时输入，直接使用样条的求值结果
+// 没有脚本或已播放完时返回false，缩放重新由热键控制
+static bool apply_timeline(struct zoom_filter *filter, uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    struct timeline_data *timeline = filter->timeline;
+    float scale, x, y;
+    
+    if (!timeline || !timeline->count || filter->timeline_ended)
+        return false;
+    
+    if (!filter->timeline_start) {
+        filter->timeline_start = current_time;
+    }
+    uint64_t t = current_time - filter->timeline_start;
+    
+    discard_commands(filter);
+    timeline_evaluate(timeline, t, &scale, &x, &y);
+    smoothing_jump_to(&ctl->smoothing, (float)fmax(fmin((double)scale, 5.0), 1.0));
+    if (timeline->has_center) {
+        tracking_set_position(&ctl->tracking, x, y);
+    }
+    
+    // 最后一帧之后从现在开始计算自动复位
+    if (timeline_finished(timeline, t)) {
+        filter->timeline_ended = true;
+        ctl->last_zoom_time = current_time;
+    }
+    return true;
+}
+
+// 录制：把控制器最近一次模拟的状态交给写入线程（不阻塞）。组员录制组长模拟的结果，
+// 组员可能先于组长执行，因此按模拟的帧时间去重，每个模拟帧只录制一次
+static void push_record(struct zoom_filter *filter)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    struct zoom_log_record record;
+    
+    if (ctl->frame_time == filter->recorded_time)
+        return;
+    filter->recorded_time = ctl->frame_time;
+    
+    record.frame_ts = ctl->frame_time;
+    record.scale = ctl->smoothing.current_scale;
+    tracking_get_center(&ctl->tracking, 1.0f, 1.0f, &record.center_x, &record.center_y);
+    record.events = ctl->frame_events;
+    recorder_push(&filter->record->recorder, &record);
+}
+
+// 组员不模拟控制器：录制时记录组长模拟的结果，回放被忽略（由组长回放）。
+// 每个会话或组内角色变化后只提示一次
+static void note_follower_record(struct zoom_filter *filter)
+{
+    if (filter->record_noted)
+        return;
+    filter->record_noted = true;
+    
+    const char *group = group_link_name(&filter->link);
+    if (filter->record->mode == RECORD_MODE_REPLAY) {
+        obs_log(LOG_WARNING, "Replay is ignored while following zoom group '%s'; "
+                "only the group leader replays", group);
+    } else {
+        obs_log(LOG_INFO, "Recording the zoom of group '%s' as simulated by its leader", group);
+    }
+}
+
+// 应用设置中的组（仅渲染线程调用）。控制器或组长变化时返回true，
+// 由调用方按本实例已有的参数重新配置控制器，这里不重新读取设置
+static bool refresh_group(struct zoom_filter *filter)
+{
+    bool changed = group_link_apply(&filter->link);
+    if (changed) {
+        struct zoom_controller *ctl = filter->link.controller;
+        filter->rendering.tracking = &ctl->tracking;
+        filter->rendering.smoothing = &ctl->smoothing;
+        filter->saved_serial = ctl->scale_serial;
+        filter->latency_pending = false;
+    }
+    
+    bool leading = group_link_is_leader(&filter->link);
+    if (leading != filter->leading) {
+        os_atomic_set_bool(&filter->leading, leading);
+        filter->record_noted = false;
+        changed = true;
+    }
+    return changed;
+}
+
+// 取设置线程发布的最新参数（仅渲染线程调用），有新参数时返回true
+static bool take_params(struct zoom_filter *filter)
+{
+    void *params;
+    
+    if (!mailbox_take(&filter->params_box, &params))
+        return false;
+    bfree(filter->params);
+    filter->params = params;
+    return true;
+}
+
+// 参数变化、控制器切换或成为组长时重新配置（仅渲染线程调用），只复制内存中的参数
+static void apply_params(struct zoom_filter *filter, uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    const struct zoom_params *params = filter->params;
+    
+    filter->rendering.mode = params->render_mode;
+    if (filter->leading) {
+        apply_controller(ctl, params);
+    }
+    
+    // 用户在设置中修改了缩放值（链接组时作用于共享的控制器）
+    if (params->scale_serial != filter->applied_scale_serial) {
+        filter->applied_scale_serial = params->scale_serial;
+        smoothing_set_target(&ctl->smoothing, params->scale, current_time);
+        
+        // 之前尚未写回的运行时缩放不再写回，以免覆盖用户刚修改的值
+        filter->saved_serial = ctl->scale_serial;
+        filter->flush_pending = false;
+        os_atomic_set_bool(&filter->scale_unsaved, false);
+    }
+}
+
+// 跟踪模式每帧检查（回放和脚本可能随时开始或结束）；重新配置时也重新设置，
+// 光标后端之前不可用时借此重试
+static void refresh_tracking_mode(struct zoom_filter *filter, bool external, bool reapply)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    int mode = effective_tracking_mode(filter, external);
+    
+    if (reapply || ctl->tracking.mode != mode) {
+        tracking_set_mode(&ctl->tracking, mode);
+    }
+}
+
+// 模拟控制器且启用了手势缩放时才持有采样线程（手势由采样线程收集），
+// 开始读取时跳过之前累计的输入
+static void refresh_gesture(struct zoom_filter *filter)
+{
+    bool wanted = filter->leading && filter->params->gesture_enabled;
+    
+    if (wanted == filter->gesture_acquired) {
+        return;
+    }
+    if (wanted) {
+        if (!cursor_sampler_acquire()) {
+            return;
         }
+        cursor_sampler_gesture_sync(&filter->gesture);
     } else {
-        filter->scale = target;
-        filter->target_scale = target;
-        save_scale(filter, target);
+        cursor_sampler_release();
     }
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
+    filter->gesture_acquired = wanted;
 }
 
-static void zoom_filter_video_render(void *data, gs_effect_t *effect)
+// 滚轮和捏合缩放：采样线程已把任意多个事件累加成总量，这里每帧只取一次差值，
+// 合并成一次目标变化。回放和脚本播放期间读取后丢弃
+static void apply_gesture(struct zoom_filter *filter, bool live, float width, float height,
+                          uint64_t current_time)
+{
+    struct zoom_controller *ctl = filter->link.controller;
+    struct cursor_gesture delta;
+    
+    if (!filter->gesture_acquired || !cursor_sampler_gesture_read(&filter->gesture, &delta) ||
+        !live) {
+        return;
+    }
+    
+    // 滚轮和捏合都按比例缩放，同样的手势在任何缩放值下幅度一致
+    const struct zoom_params *params = filter->params;
+    float exponent = delta.wheel[params->wheel_modifier] * log1pf(params->wheel_step) +
+                     delta.pinch;
+    if (exponent == 0.0f) {
+        return;
+    }
+    float old_target = ctl->smoothing.target_scale;
+    apply_zoom(filter, old_target * expf(exponent), current_time);
+    ctl->last_zoom_time = current_time;
+    float new_target = ctl->smoothing.target_scale;
+    
+    // 以光标为中心：固定视图时平移中心，使光标下的点停在原来的屏幕位置；
+    // 跟踪模式下中心本来就跟随光标（或画面活动），不额外平移
+    struct cursor_sample sample;
+    if (new_target == old_target || ctl->tracking.mode != TRACKING_MODE_DISABLED ||
+        !cursor_sampler_get_frame(current_time, &sample)) {
+        return;
+    }
+    
+    float px, py, cx, cy;
+    if (ctl->tracking.mapping.valid) {
+        mapping_apply(&ctl->tracking.mapping, sample.x, sample.y, &px, &py);
+    } else {
+        px = sample.x / width;
+        py = sample.y / height;
+    }
+    if (px < 0.0f || px > 1.0f || py < 0.0f || py > 1.0f) {
+        return;     // 光标不在捕获区域内，按当前中心缩放
+    }
+    if (ctl->tracking.pan_active) {
+        cx = ctl->tracking.pan_x;
+        cy = ctl->tracking.pan_y;
+    } else {
+        tracking_get_center(&ctl->tracking, 1.0f, 1.0f, &cx, &cy);
+    }
+    float ratio = old_target / new_target;
+    tracking_pan_to(&ctl->tracking, px + (cx - px) * ratio, py + (cy - py) * ratio);
+}
+
+// 推进缩放/平移模拟：每个视频帧只调用一次，与该帧被渲染几次（预览、投影、多视图）
+// 以及源是否可见无关；链接组时只有组长模拟，所有成员绘制同一个状态
+static void zoom_filter_video_tick(void *data, float seconds)
 {
     struct zoom_filter *filter = data;
     obs_source_t *target = obs_filter_get_target(filter->context);
     
     if (!target) {
-        obs_source_skip_video_filter(filter->context);
         return;
     }
 
-    uint64_t current_time = os_gettime_ns();
-<<<<<<< HEAD
+    bool reapply = refresh_group(filter);
+    reapply = take_params(filter) || reapply;
+    
+    // 所有计时都使用视频帧时间，渲染抖动不会变成运动抖动；
+    // 可选在帧中间求值，使编码后的运动更平滑
+    uint64_t current_time = obs_get_video_frame_time();
+    if (filter->params->midframe_eval) {
+        current_time += (uint64_t)((double)seconds * 500000000.0);
+    }
+    
+    if (reapply) {
+        apply_params(filter, current_time);
+    }
+    group_link_forward(&filter->link);
+    refresh_record(filter);
+    refresh_timeline(filter);
+    refresh_gesture(filter);
+    struct zoom_controller *ctl = filter->link.controller;
+    if (!filter->leading) {
+        if (filter->record) {
+            note_follower_record(filter);
+            if (filter->record->mode == RECORD_MODE_RECORD)
+                push_record(filter);
+        }
+        publish_unsaved_scale(filter, current_time);
+        publish_scale(filter, ctl);
+        return;
+    }
+    
+    profile_start(tick_name);
+    uint64_t tick_start = os_gettime_ns();
+    uint64_t phase_start = tick_start;
+    
+    // 应用热键命令（回放时改为应用录制的轨迹，脚本播放时改为应用时间轴）
+    profile_start(update_name);
+    ctl->frame_time = current_time;
+    ctl->frame_events = 0;
+    bool replaying = filter->record && filter->record->mode == RECORD_MODE_REPLAY;
+    if (replaying) {
+        apply_replay(filter, current_time);
+    }
+    bool scripted = !replaying && apply_timeline(filter, current_time);
+    if (!replaying && !scripted) {
+        process_commands(filter, current_time);
+    }
+    refresh_tracking_mode(filter, external_center(filter), reapply);
+    profile_end(update_name);
+    uint64_t update_time = os_gettime_ns() - phase_start;
     
     // 更新跟踪模块
+    profile_start(tracking_name);
+    phase_start = os_gettime_ns();
     uint32_t width = obs_source_get_width(target);
     uint32_t height = obs_source_get_height(target);
-    static float last_scale = 1.0f; // 存储上一帧的缩放值
-    tracking_update_mouse(&filter->tracking,
-                        (float)width, (float)height,
-                        filter->smoothing.current_scale,
-                        last_scale, // 使用真正的上一帧缩放值
-                        current_time);
+    if (width && height) {
+        if (ctl->tracking.mode != TRACKING_MODE_DISABLED || filter->gesture_acquired) {
+            // 解析父源捕获的显示器/区域（已缓存，仅在布局或尺寸变化时重新解析）
+            mapping_refresh(&ctl->tracking.mapping, obs_filter_get_parent(filter->context),
+                            width, height);
+        }
+        apply_gesture(filter, !replaying && !scripted, (float)width, (float)height,
+                      current_time);
+        float focus_x, focus_y;
+        if (activity_get_focus(&filter->activity, &focus_x, &focus_y)) {
+            tracking_set_focus(&ctl->tracking, focus_x, focus_y);
+        }
+        tracking_update_mouse(&ctl->tracking,
+                            (float)width, (float)height,
+                            ctl->smoothing.current_scale,
+                            ctl->last_scale, // 本控制器上一帧的缩放值
+                            current_time);
+    }
     // 记录当前缩放值，供下一帧使用
-    last_scale = filter->smoothing.current_scale;
+    ctl->last_scale = ctl->smoothing.current_scale;
+    profile_end(tracking_name);
+    uint64_t now = os_gettime_ns();
+    histogram_record(&filter->stats.phase[STATS_PHASE_TRACKING], now - phase_start);
     
     // 更新平滑模块
-    float scale = smoothing_update(&filter->smoothing, current_time);
+    profile_start(smoothing_name);
+    phase_start = now;
+    smoothing_update(&ctl->smoothing, current_time);
+    profile_end(smoothing_name);
+    now = os_gettime_ns();
+    histogram_record(&filter->stats.phase[STATS_PHASE_SMOOTHING], now - phase_start);
+    
+    profile_start(update_name);
+    phase_start = now;
     
-=======
-
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
     // 处理长按缩放
-    if (current_time - filter->last_zoom_time > filter->response_time) {
-        if (filter->zoom_in_pressed) {
-            float target = filter->smoothing.target_scale + filter->continuous_step;
-            apply_zoom(filter, target);
-            filter->last_zoom_time = current_time;
-        } else if (filter->zoom_out_pressed) {
-            float target = filter->smoothing.target_scale - filter->continuous_step;
-            apply_zoom(filter, target);
-            filter->last_zoom_time = current_time;
-        }
+    update_held_zoom(filter, current_time);
+
+    // 处理自动复位（回放和脚本播放时缩放完全由轨迹决定）
+    if (!replaying && !scripted && filter->params->auto_reset_time > 0 &&
+        !ctl->zoom_in_pressed && !ctl->zoom_out_pressed &&
+        current_time - ctl->last_zoom_time > filter->params->auto_reset_time) {
+        apply_zoom(filter, 1.0f, current_time);
+        ctl->last_zoom_time = current_time;
     }
+    
+    // 写回停止变化的缩放值
+    publish_unsaved_scale(filter, current_time);
+    
+    // 录制本帧
+    if (filter->record && filter->record->mode == RECORD_MODE_RECORD) {
+        push_record(filter);
+    }
+    
+    profile_end(update_name);
+    now = os_gettime_ns();
+    update_time += now - phase_start;
+    histogram_record(&filter->stats.phase[STATS_PHASE_UPDATE], update_time);
+    
+    // 本帧模拟耗时，加上首次绘制的耗时后计入每帧总耗时
+    filter->tick_cost = now - tick_start;
+    filter->tick_cost_pending = true;
+    publish_scale(filter, ctl);
+    profile_end(tick_name);
+}
 
-    // 处理自动复位
-    if (filter->auto_reset_time > 0 && 
-        !filter->zoom_in_pressed && !filter->zoom_out_pressed &&
-        current_time - filter->last_zoom_time > filter->auto_reset_time) {
-        apply_zoom(filter, 1.0f);
-        filter->last_zoom_time = current_time;
+// 只绘制最新的模拟状态，不推进任何状态
+static void zoom_filter_video_render(void *data, gs_effect_t *effect)
+{
+    struct zoom_filter *filter = data;
+    struct zoom_controller *ctl = filter->link.controller;
+    obs_source_t *target = obs_filter_get_target(filter->context);
+    
+    if (!target) {
+        obs_source_skip_video_filter(filter->context);
+        return;
+    }
+    
+    // 自动取景：按间隔缩小读回原始画面，交给工作线程分析
+    if (filter->leading && ctl->tracking.mode == TRACKING_MODE_ACTIVITY) {
+        profile_start(activity_name);
+        activity_capture(&filter->activity, target, obs_source_get_width(target),
+                         obs_source_get_height(target), obs_get_video_frame_time());
+        profile_end(activity_name);
     }
-<<<<<<< HEAD
     
     // 执行渲染
+    profile_start(render_name);
+    uint64_t render_start = os_gettime_ns();
     rendering_render(&filter->rendering, target, effect);
-}
-
-void zoom_in(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
-=======
-
-    // 处理平滑过渡
-    if (filter->smooth_enabled && filter->transition_start > 0) {
-        filter->scale = calculate_smooth_scale(filter, current_time);
+    uint64_t now = os_gettime_ns();
+    profile_end(render_name);
+    histogram_record(&filter->stats.phase[STATS_PHASE_RENDER], now - render_start);
+    if (filter->tick_cost_pending) {
+        filter->tick_cost_pending = false;
+        histogram_record(&filter->stats.frame_cost, filter->tick_cost + now - render_start);
     }
+    
+    // 热键触发的缩放第一次出现在画面上
+    if (filter->latency_pending && ctl->smoothing.current_scale != filter->latency_scale) {
+        filter->latency_pending = false;
+        if (now > filter->latency_command_time) {
+            histogram_record(&filter->stats.input_latency, now - filter->latency_command_time);
+        }
+    }
+}
 
-    struct vec4 clear_color;
-    vec4_zero(&clear_color);
-    gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
-    gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
-
-    float scale = filter->scale;
-    float half_w = width * 0.5f;
-    float half_h = height * 0.5f;
-
-    gs_matrix_push();
-    gs_matrix_translate3f(half_w, half_h, 0.0f);
-    gs_matrix_scale3f(scale, scale, 1.0f);
-    gs_matrix_translate3f(-half_w, -half_h, 0.0f);
-
-    obs_source_video_render(target);
-
-    gs_matrix_pop();
+// 热键回调运行在热键线程，只把命令交给控制器的队列，由渲染线程统一执行
+static void submit_key(struct zoom_filter *filter, int type, bool pressed)
+{
+    struct zoom_command command = {
+        .type = type,
+        .pressed = pressed,
+        .timestamp = os_gettime_ns(),
+    };
+    group_link_submit(&filter->link, &command);
 }
 
-static void zoom_in(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
+void zoom_in(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
 {
     UNUSED_PARAMETER(id);
     
     struct zoom_filter *filter = data;
     if (!filter || !filter->context) return;
     
-    filter->zoom_in_pressed = pressed;
     filter->zoom_in_key = hotkey;
-    
-    if (pressed) {
-<<<<<<< HEAD
-        float target = filter->smoothing.target_scale + filter->single_click_step;
-=======
-        float target = filter->target_scale + filter->single_click_step;
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
-        apply_zoom(filter, target);
-        filter->last_zoom_time = os_gettime_ns();
-    }
+    submit_key(filter, ZOOM_CMD_IN, pressed);
 }
 
 void zoom_out(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
@@ -307,18 +1125,8 @@ void zoom_out(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
     struct zoom_filter *filter = data;
     if (!filter || !filter->context) return;
     
-    filter->zoom_out_pressed = pressed;
     filter->zoom_out_key = hotkey;
-    
-    if (pressed) {
-<<<<<<< HEAD
-        float target = filter->smoothing.target_scale - filter->single_click_step;
-=======
-        float target = filter->target_scale - filter->single_click_step;
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
-        apply_zoom(filter, target);
-        filter->last_zoom_time = os_gettime_ns();
-    }
+    submit_key(filter, ZOOM_CMD_OUT, pressed);
 }
 
 void zoom_reset(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
@@ -331,13 +1139,16 @@ void zoom_reset(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed
     struct zoom_filter *filter = data;
     if (!filter || !filter->context) return;
     
-    apply_zoom(filter, 1.0f);
-    filter->last_zoom_time = os_gettime_ns();
+    submit_key(filter, ZOOM_CMD_RESET, true);
 }
 
 static void zoom_filter_save(void *data, obs_data_t *hotkeys)
 {
     struct zoom_filter *filter = data;
+    
+    // 保存场景集合时写回尚未持久化的缩放值
+    flush_scale(filter, hotkeys);
+    
     obs_data_array_t *save_array = obs_hotkey_save(filter->zoom_in_hotkey);
     obs_data_set_array(hotkeys, "zoom_in_hotkey", save_array);
     obs_data_array_release(save_array);
@@ -367,6 +1178,25 @@ static void zoom_filter_load(void *data, obs_data_t *hotkeys)
     obs_data_array_release(load_array);
 }
 
+static void zoom_filter_deactivate(void *data)
+{
+    struct zoom_filter *filter = data;
+    
+    // 不等停止缩放的延迟，尽快写回（由UI线程写入设置）
+    if (os_atomic_load_bool(&filter->scale_unsaved)) {
+        queue_flush_scale(filter);
+    }
+    
+    // 不可见期间的等待不算作输入延迟
+    filter->latency_pending = false;
+}
+
+// 源切换到节目输出时从头播放脚本，录制教程时时间轴与场景切换对齐
+static void zoom_filter_activate(void *data)
+{
+    zoom_filter_restart_timeline(data);
+}
+
 struct obs_source_info zoom_filter = {
     .id = "zoom_filter",
     .type = OBS_SOURCE_TYPE_FILTER,
@@ -375,6 +1205,9 @@ struct obs_source_info zoom_filter = {
     .create = zoom_filter_create,
     .destroy = zoom_filter_destroy,
     .update = zoom_filter_update,
+    .activate = zoom_filter_activate,
+    .deactivate = zoom_filter_deactivate,
+    .video_tick = zoom_filter_video_tick,
     .video_render = zoom_filter_video_render,
     .get_properties = zoom_filter_get_properties,
     .get_defaults = zoom_filter_get_defaults,
@@ -6,6 +6,14 @@
 #include "zoom-tracking.h"
 #include "zoom-smoothing.h"
 #include "zoom-rendering.h"
+#include "zoom-command.h"
+#include "zoom-mailbox.h"
+#include "zoom-stats.h"
+#include "zoom-activity.h"
+#include "zoom-recorder.h"
+#include "zoom-timeline.h"
+#include "zoom-group.h"
+#include "zoom-sampler.h"
 
 #define S_ZOOM_IN "zoom_in"
 #define S_ZOOM_OUT "zoom_out" 
@@ -15,9 +23,14 @@
 #define S_TRACKING_MODE "tracking_mode"
 #define S_SCALE_FACTOR "scale_factor"
 #define S_SINGLE_STEP "single_click_step"
-#define S_CONT_STEP "continuous_step"
+#define S_ZOOM_RATE "zoom_rate"
+#define S_ZOOM_RATE_RELATIVE "zoom_rate_relative"
+#define S_ZOOM_RAMP "zoom_ramp"
 #define S_TRACKING_SMOOTH_ENABLED "tracking_smooth_enabled"
 #define S_TRACKING_SMOOTHNESS "tracking_smoothness"
+#define S_DEAD_ZONE_WIDTH "dead_zone_width"
+#define S_DEAD_ZONE_HEIGHT "dead_zone_height"
+#define S_SETTLE_THRESHOLD "settle_threshold"
 #define S_SMOOTH_ENABLED "smooth_enabled"
 #define S_SMOOTHNESS "smoothness"
 #define S_SMOOTH_MODE "smoothing_mode"
@@ -27,52 +40,165 @@
 #define S_START_SPEED "start_speed"
 #define S_END_DECEL "end_deceleration"
 #define S_OVERSHOOT "overshoot"
+#define S_PREDICT_MODE "predict_mode"
+#define S_PREDICT_HORIZON "predict_horizon"
+#define S_RENDER_MODE "render_mode"
+#define S_MIDFRAME_EVAL "midframe_eval"
+#define S_ACTIVITY_INTERVAL "activity_interval"
+#define S_ACTIVITY_DOWNSCALE "activity_downscale"
+#define S_RECORD_MODE "record_mode"
+#define S_RECORD_PATH "record_path"
+#define S_REPLAY_PATH "replay_path"
+#define S_TIMELINE_PATH "timeline_path"
+#define S_TIMELINE_RESTART "timeline_restart"
+#define S_ZOOM_GROUP "zoom_group"
+#define S_GESTURE_ZOOM "gesture_zoom"
+#define S_WHEEL_MODIFIER "wheel_modifier"
+#define S_WHEEL_STEP "wheel_step"
+
+// 轨迹录制模式
+#define RECORD_MODE_OFF 0       // 不录制
+#define RECORD_MODE_RECORD 1    // 录制缩放轨迹
+#define RECORD_MODE_REPLAY 2    // 回放录制的轨迹，忽略实时输入
+
+// 诊断面板（只读，不保存到设置）
+#define S_DIAGNOSTICS "diagnostics"
+#define S_DIAG_SCALE "diag_scale"
+#define S_DIAG_CENTER "diag_center"
+#define S_DIAG_SAMPLE_RATE "diag_sample_rate"
+#define S_DIAG_RENDER_PATHS "diag_render_paths"
+#define S_DIAG_FRAME_COST "diag_frame_cost"
+#define S_DIAG_REFRESH "diag_refresh"
+
+// 延迟统计摘要的缓冲区大小
+#define STATS_TEXT_SIZE 1024
+
+// 停止缩放多久后把缩放值写回设置(ns)
+#define SCALE_SAVE_DELAY 1000000000ULL
+
+// 设置线程读取、渲染线程应用的参数。每次更新设置都整体重建一份，经邮箱交给渲染线程，
+// 渲染线程不会读到更新了一半的设置
+struct zoom_params {
+    // 跟踪（只有模拟控制器的实例写入控制器）
+    int tracking_mode;             // 设置中的模式，回放或脚本控制中心时改用外部模式
+    bool tracking_smooth;
+    float tracking_smoothness;
+    float dead_zone_x;
+    float dead_zone_y;
+    float settle_threshold;
+    int predict_mode;
+    int predict_horizon;
+    
+    // 平滑设置和已建好的缓动曲线表（同上）
+    struct smoothing_data smoothing;
+    
+    // 本实例的绘制和手势
+    int render_mode;
+    bool midframe_eval;            // 在帧中间时刻求值动画
+    bool gesture_enabled;          // 设置中启用了手势缩放
+    int wheel_modifier;            // 滚轮缩放需要按住的修饰键（CURSOR_MOD_*）
+    float wheel_step;              // 每格滚轮的缩放比例（0.1表示10%）
+    
+    // 热键缩放（连续缩放的速度和加速时间在smoothing中）
+    float single_click_step;       // 单击步长
+    uint64_t response_time;        // 长按多久后开始连续缩放(ns)
+    uint64_t auto_reset_time;      // 自动复位时间(ns)
+    
+    // 设置中的缩放值，scale_serial变化表示用户修改了缩放值
+    float scale;
+    long scale_serial;
+};
+
+// 一次轨迹录制或回放（设置线程打开文件，经邮箱交给渲染线程，
+// 渲染线程换下的会话交给销毁线程停止录制和解除映射）
+struct record_session {
+    int mode;                      // RECORD_MODE_RECORD或RECORD_MODE_REPLAY
+    struct recorder_data recorder;
+    struct replay_file replay_file;
+    struct replay_data replay;
+};
+
+// 其他线程读取的最近一次模拟结果：渲染线程每帧发布一次（写入前后各递增序号），
+// 读者在序号为奇数或读取期间变化时重试，读到的所有值来自同一帧。缩放值和坐标存的是float的位
+struct zoom_state_snapshot {
+    volatile long seq;
+    volatile long scale;
+    volatile long target_scale;
+    volatile long center_x;        // 源内相对坐标
+    volatile long center_y;
+    volatile long panning;         // 中心由程序指定（PAN_TO）
+};
 
 // 主过滤器结构体
 struct zoom_filter {
     obs_source_t *context;    // OBS上下文
     
     // 模块数据
-    struct tracking_data tracking;     // 鼠标跟踪模块
-    struct smoothing_data smoothing;   // 平滑效果模块
+    struct group_link link;            // 缩放控制器（跟踪、平滑、命令队列），链接组时与其他实例共享
+    volatile bool leading;             // 由本实例模拟控制器（未链接或是组长）
     struct rendering_data rendering;   // 渲染控制模块
+    struct activity_data activity;     // 画面活动检测（自动取景）
     
     // 热键
     obs_hotkey_id zoom_in_hotkey;
     obs_hotkey_id zoom_out_hotkey;
     obs_hotkey_id zoom_reset_hotkey;
-    
-    // 长按支持
-    bool zoom_in_pressed;
-    bool zoom_out_pressed;
     obs_hotkey_t *zoom_in_key;
     obs_hotkey_t *zoom_out_key;
-    uint64_t last_zoom_time;
-<<<<<<< HEAD
     
-    // 缩放步长控制
-=======
-
-    // Zoom control parameters
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
-    float single_click_step;  // 单击步长
-    float continuous_step;    // 持续步长
-    uint64_t response_time;   // 响应间隔(ns)
-    uint64_t auto_reset_time; // 自动复位时间(ns)
+    // 设置（设置线程发布，渲染线程每帧取最新的一份）
+    struct mailbox params_box;
+    struct zoom_params *params;        // 正在使用的参数（仅渲染线程）
+    struct zoom_state_snapshot state;  // 最近一次模拟的结果，供get_state读取
+    struct smoothing_data curve;       // 设置线程建表用，参数未变化时不重建
+    long scale_serial;                 // 用户修改缩放值的次数（仅设置线程）
+    long applied_scale_serial;         // 已应用的scale_serial（仅渲染线程）
+    
+    // 滚轮和捏合缩放（仅渲染线程，参数见zoom_params）
+    bool gesture_acquired;         // 持有光标采样线程的引用
+    struct gesture_reader gesture; // 已读取的手势总量
+    
+    // 缩放值持久化（运行时状态只在内存中，停止缩放一段时间后由UI线程写回设置，
+    // 渲染线程只发布待写回的值，不访问设置）
+    pthread_mutex_t settings_mutex;    // 保护saved_scale（设置线程和UI线程）
+    float saved_scale;         // 设置中的缩放值
+    long saved_serial;         // 已发布的控制器scale_serial，不同表示有新的目标值（仅渲染线程）
+    bool flush_pending;        // 等待缩放停止后请求写回（仅渲染线程）
+    volatile long unsaved_scale;   // 待写回的目标缩放值（float的位）
+    volatile bool scale_unsaved;   // unsaved_scale尚未写回
+    
+    // 延迟统计
+    struct zoom_stats stats;
+    bool latency_pending;          // 等待热键触发的缩放出现在画面上
+    uint64_t latency_command_time; // 热键按下时间（os_gettime_ns时基）
+    float latency_scale;           // 热键生效前的缩放值
+    uint64_t tick_cost;            // 本帧模拟耗时(ns)
+    bool tick_cost_pending;        // 本帧尚未绘制
+    
+    // 轨迹录制/回放（设置线程切换会话，渲染线程每帧取最新的会话，不加锁）
+    int record_setting;            // 设置中选择的模式（仅设置线程）
+    char *record_path;             // 设置中选择的文件（仅设置线程）
+    struct mailbox record_box;
+    struct record_session *record; // 正在使用的会话，NULL表示不录制也不回放（仅渲染线程）
+    uint64_t recorded_time;        // 最后录制的模拟帧时间，同一帧只录制一次（仅渲染线程）
+    bool record_noted;             // 已提示本会话在组内的作用（仅渲染线程）
+    
+    // 脚本时间轴（设置线程加载和编译，渲染线程每帧取最新的一份并求值，不加锁）
+    char *timeline_path;           // 设置中选择的脚本（仅设置线程）
+    struct mailbox timeline_box;
+    struct timeline_data *timeline; // 正在播放的时间轴（仅渲染线程）
+    uint64_t timeline_start;       // 开始播放的视频帧时间，0表示从下一帧开始（仅渲染线程）
+    bool timeline_ended;           // 已应用最后一帧，之后缩放重新由热键控制（仅渲染线程）
+    volatile bool timeline_restart; // 请求从头播放，下一帧生效
 };
 
-<<<<<<< HEAD
-=======
-// Smoothing modes
-#define SMOOTH_MODE_LINEAR  0
-#define SMOOTH_MODE_EXPONENTIAL 1
-#define SMOOTH_MODE_LOGARITHMIC 2
-
->>>>>>> 48bf4d025458e267826309d3286d5f08ba700225
 extern struct obs_source_info zoom_filter;
 
 void zoom_in(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 void zoom_out(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 void zoom_reset(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 
+// 从头播放脚本时间轴（下一帧开始）
+void zoom_filter_restart_timeline(struct zoom_filter *filter);
+
 #endif
@@ -0,0 +1,257 @@
+#include "zoom-group.h"
+#include "zoom-sampler.h"
+#include <obs-module.h>
+#include <util/bmem.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <string.h>
+
+struct zoom_group {
+    char *name;
+    struct zoom_controller controller;
+    DARRAY(struct group_link *) members;   // 按加入顺序，第一个是组长
+    struct zoom_group *next;
+};
+
+// 所有组的列表；加入/离开组和切换控制器都在这个锁内进行。
+// 每次变化都增加版本号，渲染线程只在版本号变化后才加锁重新应用
+static pthread_mutex_t group_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct zoom_group *groups = NULL;
+static volatile long group_generation = 0;
+
+static void controller_init(struct zoom_controller *controller)
+{
+    memset(controller, 0, sizeof(*controller));
+    tracking_init(&controller->tracking, &cursor_sampler_source);
+    smoothing_init(&controller->smoothing);
+    command_queue_init(&controller->commands);
+    controller->last_scale = controller->smoothing.current_scale;
+}
+
+static void controller_free(struct zoom_controller *controller)
+{
+    long dropped = os_atomic_load_long(&controller->commands.dropped);
+    if (dropped > 0) {
+        blog(LOG_WARNING, "[zoom-group] %ld zoom commands dropped (queue full)", dropped);
+    }
+    tracking_free(&controller->tracking);
+}
+
+// 从另一个控制器的当前画面开始，切换控制器时不跳变
+static void controller_seed(struct zoom_controller *controller, const struct zoom_controller *from)
+{
+    smoothing_jump_to(&controller->smoothing, from->smoothing.current_scale);
+    controller->last_scale = from->smoothing.current_scale;
+    tracking_set_position(&controller->tracking, from->tracking.mouse_x, from->tracking.mouse_y);
+}
+
+// 成员的按键状态变化时更新控制器的按住计数：计数从0变1时提交按下，从1变0时提交松开，
+// 同一个键绑定在多个成员上时控制器只收到一次（计数为原子操作，释放的成员可在其他线程松开）
+static bool update_held(bool *member_held, volatile long *held, bool pressed)
+{
+    if (*member_held == pressed)
+        return false;
+    *member_held = pressed;
+    return pressed ? os_atomic_inc_long(held) == 1 : os_atomic_dec_long(held) == 0;
+}
+
+static void release_held(struct group_link *link)
+{
+    struct zoom_controller *controller = link->controller;
+    struct zoom_command command = {.pressed = false, .timestamp = os_gettime_ns()};
+
+    if (update_held(&link->in_held, &controller->in_held, false)) {
+        command.type = ZOOM_CMD_IN;
+        command_queue_push(&controller->commands, &command);
+    }
+    if (update_held(&link->out_held, &controller->out_held, false)) {
+        command.type = ZOOM_CMD_OUT;
+        command_queue_push(&controller->commands, &command);
+    }
+}
+
+// 加入组后不再使用的本地控制器：丢弃尚未执行的命令和按键状态，
+// 离开组时不会重放加入前的输入（需持有组锁，只在渲染线程调用）
+static void reset_input(struct zoom_controller *controller)
+{
+    struct zoom_command command;
+
+    while (command_queue_pop(&controller->commands, &command)) {}
+    controller->zoom_in_pressed = false;
+    controller->zoom_out_pressed = false;
+}
+
+static struct zoom_group *find_group(const char *name)
+{
+    for (struct zoom_group *group = groups; group; group = group->next) {
+        if (strcmp(group->name, name) == 0)
+            return group;
+    }
+    return NULL;
+}
+
+static void remove_member(struct group_link *link)
+{
+    struct zoom_group *group = link->group;
+
+    if (!group)
+        return;
+
+    da_erase_item(group->members, &link);
+    link->group = NULL;
+    link->controller = &link->local;
+    os_atomic_inc_long(&group_generation);
+
+    if (group->members.num > 0) {
+        // 组长离开后由下一个成员接管模拟
+        return;
+    }
+
+    struct zoom_group **prev = &groups;
+    while (*prev != group)
+        prev = &(*prev)->next;
+    *prev = group->next;
+
+    blog(LOG_INFO, "[zoom-group] group '%s' closed", group->name);
+    controller_free(&group->controller);
+    da_free(group->members);
+    bfree(group->name);
+    bfree(group);
+}
+
+void group_link_init(struct group_link *link)
+{
+    controller_init(&link->local);
+    link->controller = &link->local;
+    link->group = NULL;
+    link->request = NULL;
+    link->pending = false;
+    command_queue_init(&link->input);
+    link->in_held = false;
+    link->out_held = false;
+    link->generation = -1;
+    link->leader = true;
+}
+
+void group_link_free(struct group_link *link)
+{
+    pthread_mutex_lock(&group_mutex);
+    release_held(link);
+    remove_member(link);
+    pthread_mutex_unlock(&group_mutex);
+
+    long dropped = os_atomic_load_long(&link->input.dropped);
+    if (dropped > 0) {
+        blog(LOG_WARNING, "[zoom-group] %ld zoom commands dropped (input queue full)", dropped);
+    }
+    controller_free(&link->local);
+    bfree(link->request);
+    link->request = NULL;
+}
+
+void group_link_request(struct group_link *link, const char *name)
+{
+    pthread_mutex_lock(&group_mutex);
+    if (!link->request || strcmp(link->request, name) != 0) {
+        bfree(link->request);
+        link->request = bstrdup(name);
+        link->pending = true;
+        os_atomic_inc_long(&group_generation);
+    }
+    pthread_mutex_unlock(&group_mutex);
+}
+
+bool group_link_apply(struct group_link *link)
+{
+    struct zoom_controller *old = link->controller;
+
+    // 没有任何成员变化：组和组长都与上次相同
+    if (os_atomic_load_long(&group_generation) == link->generation)
+        return false;
+
+    pthread_mutex_lock(&group_mutex);
+    if (link->pending) {
+        const char *name = link->request;
+        struct zoom_group *group = *name ? find_group(name) : NULL;
+
+        link->pending = false;
+
+        if (group && group == link->group) {
+            // 已在请求的组中
+        } else if (group) {
+            // 加入已有的组，直接跟随组的状态
+            release_held(link);
+            remove_member(link);
+            da_push_back(group->members, &link);
+            link->group = group;
+            link->controller = &group->controller;
+            os_atomic_inc_long(&group_generation);
+        } else if (*name) {
+            // 新建组，从当前画面开始；原来所在组的其他成员不受影响
+            group = bzalloc(sizeof(*group));
+            group->name = bstrdup(name);
+            controller_init(&group->controller);
+            controller_seed(&group->controller, old);
+            da_push_back(group->members, &link);
+            group->next = groups;
+            groups = group;
+            blog(LOG_INFO, "[zoom-group] group '%s' created", name);
+
+            release_held(link);
+            remove_member(link);
+            link->group = group;
+            link->controller = &group->controller;
+            os_atomic_inc_long(&group_generation);
+        } else if (link->group) {
+            // 离开组，本地控制器从组的当前画面开始（在组可能被销毁之前复制）
+            release_held(link);
+            controller_seed(&link->local, old);
+            remove_member(link);
+        }
+
+        // 不再模拟的控制器不必继续占用光标采样
+        if (link->controller != &link->local) {
+            tracking_set_mode(&link->local.tracking, TRACKING_MODE_DISABLED);
+            reset_input(&link->local);
+        }
+    }
+    link->leader = !link->group || link->group->members.array[0] == link;
+    link->generation = os_atomic_load_long(&group_generation);
+    pthread_mutex_unlock(&group_mutex);
+
+    return link->controller != old;
+}
+
+bool group_link_is_leader(const struct group_link *link)
+{
+    return link->leader;
+}
+
+const char *group_link_name(const struct group_link *link)
+{
+    return link->group ? link->group->name : NULL;
+}
+
+bool group_link_submit(struct group_link *link, const struct zoom_command *command)
+{
+    return command_queue_push(&link->input, command);
+}
+
+void group_link_forward(struct group_link *link)
+{
+    struct zoom_controller *controller = link->controller;
+    struct zoom_command command;
+
+    while (command_queue_pop(&link->input, &command)) {
+        bool submit = true;
+
+        if (command.type == ZOOM_CMD_IN)
+            submit = update_held(&link->in_held, &controller->in_held, command.pressed);
+        else if (command.type == ZOOM_CMD_OUT)
+            submit = update_held(&link->out_held, &controller->out_held, command.pressed);
+
+        if (submit)
+            command_queue_push(&controller->commands, &command);
+    }
+}
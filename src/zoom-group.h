@@ -0,0 +1,79 @@
+#ifndef ZOOM_GROUP_H
+#define ZOOM_GROUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "zoom-tracking.h"
+#include "zoom-smoothing.h"
+#include "zoom-command.h"
+
+// 缩放控制器：一次缩放/平移模拟的全部状态
+struct zoom_controller {
+    struct tracking_data tracking;     // 鼠标跟踪
+    struct smoothing_data smoothing;   // 平滑效果
+    float last_scale;                  // 上一帧的缩放值
+
+    // 各成员转交给模拟的命令（渲染线程转交，离开的成员在释放时提交松开）
+    struct command_queue commands;
+    volatile long in_held;             // 按住放大/缩小键的成员数，同一个键绑定在多个成员上时只提交一次
+    volatile long out_held;
+
+    // 长按支持（仅渲染线程读写）
+    bool zoom_in_pressed;
+    bool zoom_out_pressed;
+    uint64_t last_zoom_time;
+
+    // 输入改变目标缩放值的次数和最后一次的时间，各成员据此把缩放值写回自己的设置
+    long scale_serial;
+    uint64_t scale_changed;
+
+    // 最近一次模拟的视频帧时间和该帧处理的输入事件（ZOOM_LOG_EVENT_*，仅渲染线程），
+    // 各成员据此录制同一条轨迹
+    uint64_t frame_time;
+    uint32_t frame_events;
+};
+
+struct zoom_group;
+
+// 滤镜与控制器的链接：未链接时使用自己的控制器，加入同名的组后共享组的控制器。
+// 组内第一个成员（组长）每帧模拟一次，其他成员只读取结果绘制，画面因此完全一致
+struct group_link {
+    struct zoom_controller local;          // 未链接时使用的控制器
+    struct zoom_controller *controller;    // 当前使用的控制器（渲染线程切换，切换时持有组锁）
+    struct zoom_group *group;              // 所在的组，未链接时为NULL
+    char *request;                         // 设置中的组名（组锁保护）
+    bool pending;                          // request尚未应用（组锁保护）
+    struct command_queue input;            // 本成员提交的命令，渲染线程每帧转交给当前控制器
+    bool in_held;                          // 本成员的热键是否按住（仅渲染线程和释放时）
+    bool out_held;
+    long generation;                       // 上次应用时所有组的版本号（仅渲染线程）
+    bool leader;                           // 上次应用时是否由本成员模拟（仅渲染线程）
+};
+
+// 初始化/释放链接（释放时离开所在的组，最后一个成员离开时销毁组）
+void group_link_init(struct group_link *link);
+void group_link_free(struct group_link *link);
+
+// 设置线程：请求加入名为name的组（空字符串表示不链接），由渲染线程在下一帧应用
+void group_link_request(struct group_link *link, const char *name);
+
+// 渲染线程：应用请求的组，控制器发生变化时返回true。
+// 新建的组和重新使用的本地控制器从原来的缩放值开始，加入已有的组时直接跟随组的状态。
+// 任何成员加入、离开或请求新的组都会增加版本号，版本号未变化时不加锁直接返回
+bool group_link_apply(struct group_link *link);
+
+// 是否由本成员模拟控制器（未链接或是组长），返回上次应用时的结果（仅渲染线程）
+bool group_link_is_leader(const struct group_link *link);
+
+// 所在组的名称，未链接时返回NULL（仅渲染线程）
+const char *group_link_name(const struct group_link *link);
+
+// 提交命令（热键线程、proc_handler的调用线程，可并发调用，不加锁），队列满时返回false
+bool group_link_submit(struct group_link *link, const struct zoom_command *command);
+
+// 渲染线程：把本成员提交的命令转交给当前控制器，每帧开始时调用。
+// 多个成员同时按住的重复按下/松开只转交第一次/最后一次；
+// 组员在组长之后转交的命令下一帧生效
+void group_link_forward(struct group_link *link);
+
+#endif // ZOOM_GROUP_H
@@ -0,0 +1,52 @@
+#include "zoom-mailbox.h"
+#include <obs-module.h>
+#include <util/threading.h>
+
+#define MAILBOX_FRESH 4
+#define MAILBOX_INDEX 3
+
+void mailbox_init(struct mailbox *box)
+{
+    box->slots[0] = NULL;
+    box->slots[1] = NULL;
+    box->slots[2] = NULL;
+    box->back = 0;
+    box->shared = 1;
+    box->front = 2;
+}
+
+void *mailbox_post(struct mailbox *box, void *item)
+{
+    box->slots[box->back] = item;
+
+    // 先写槽位再交换下标，消费者看到新下标时对象已经完整
+    long previous = os_atomic_exchange_long(&box->shared, box->back | MAILBOX_FRESH);
+    box->back = previous & MAILBOX_INDEX;
+
+    // 换回的槽位要么是消费者清空的，要么是上一次发布后没被取走的对象
+    void *stale = box->slots[box->back];
+    box->slots[box->back] = NULL;
+    return (previous & MAILBOX_FRESH) ? stale : NULL;
+}
+
+bool mailbox_take(struct mailbox *box, void **item)
+{
+    if (!(os_atomic_load_long(&box->shared) & MAILBOX_FRESH))
+        return false;
+
+    long previous = os_atomic_exchange_long(&box->shared, box->front);
+    box->front = previous & MAILBOX_INDEX;
+
+    *item = box->slots[box->front];
+    box->slots[box->front] = NULL;
+    return true;
+}
+
+void *mailbox_drain(struct mailbox *box)
+{
+    void *item = NULL;
+
+    if (!mailbox_take(box, &item))
+        return NULL;
+    return item;
+}
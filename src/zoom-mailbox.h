@@ -0,0 +1,28 @@
+#ifndef ZOOM_MAILBOX_H
+#define ZOOM_MAILBOX_H
+
+#include <stdbool.h>
+
+// 单生产者单消费者的最新值邮箱：生产者发布新对象，消费者每帧取最新的一个。
+// 三个槽位通过原子交换下标传递所有权，双方都不加锁也不等待，
+// 消费者来不及取走的旧对象由生产者在下一次发布时收回
+struct mailbox {
+    void *slots[3];
+    volatile long shared;   // 共享槽位的下标，MAILBOX_FRESH位表示尚未被取走
+    long back;              // 生产者的槽位（仅生产者访问）
+    long front;             // 消费者的槽位（仅消费者访问）
+};
+
+// 初始化邮箱（为空）
+void mailbox_init(struct mailbox *box);
+
+// 生产者：发布item，返回被替换的、消费者从未取走的旧对象（由生产者释放），没有时返回NULL
+void *mailbox_post(struct mailbox *box, void *item);
+
+// 消费者：有新发布的对象时取走并返回true，之前取走的对象仍由消费者负责释放
+bool mailbox_take(struct mailbox *box, void **item);
+
+// 双方都停止后取出尚未取走的对象（释放时使用），没有时返回NULL
+void *mailbox_drain(struct mailbox *box);
+
+#endif // ZOOM_MAILBOX_H
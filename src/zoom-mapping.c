@@ -0,0 +1,92 @@
+#include "zoom-mapping.h"
+#include "zoom-sampler.h"
+#include <string.h>
+
+// 捕获区域（桌面坐标，像素）
+struct capture_rect {
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+// 查找编号为index的显示器，不存在时返回false
+static bool find_monitor(int index, struct capture_rect *rect)
+{
+    struct cursor_monitor monitors[CURSOR_MAX_MONITORS];
+    int count = cursor_sampler_get_monitors(monitors, CURSOR_MAX_MONITORS);
+
+    if (index < 0 || index >= count)
+        return false;
+
+    rect->x = (float)monitors[index].x;
+    rect->y = (float)monitors[index].y;
+    rect->width = (float)monitors[index].width;
+    rect->height = (float)monitors[index].height;
+    return true;
+}
+
+// 根据父源类型和设置解析其捕获的桌面区域，无法识别时返回false
+static bool resolve_capture_rect(obs_source_t *parent, struct capture_rect *rect)
+{
+    const char *id = parent ? obs_source_get_unversioned_id(parent) : NULL;
+    obs_data_t *settings;
+    bool found = false;
+
+    if (!id)
+        return false;
+
+    settings = obs_source_get_settings(parent);
+    if (!settings)
+        return false;
+
+    if (strcmp(id, "xshm_input") == 0) {
+        // Linux屏幕捕获：按屏幕编号取显示器，再扣除裁剪边距
+        found = find_monitor((int)obs_data_get_int(settings, "screen"), rect);
+        if (found) {
+            float left = (float)obs_data_get_int(settings, "cut_left");
+            float top = (float)obs_data_get_int(settings, "cut_top");
+            float right = (float)obs_data_get_int(settings, "cut_right");
+            float bottom = (float)obs_data_get_int(settings, "cut_bot");
+
+            rect->x += left;
+            rect->y += top;
+            rect->width -= left + right;
+            rect->height -= top + bottom;
+        }
+    } else if (strcmp(id, "monitor_capture") == 0) {
+        // Windows显示器捕获
+        found = find_monitor((int)obs_data_get_int(settings, "monitor"), rect);
+    } else if (strcmp(id, "display_capture") == 0) {
+        // macOS显示器捕获
+        found = find_monitor((int)obs_data_get_int(settings, "display"), rect);
+    }
+
+    obs_data_release(settings);
+    return found && rect->width > 0.0f && rect->height > 0.0f;
+}
+
+void mapping_refresh(struct tracking_mapping *mapping, obs_source_t *parent,
+                     uint32_t width, uint32_t height)
+{
+    long generation = cursor_sampler_monitor_generation();
+    struct capture_rect rect;
+
+    if (mapping->valid && mapping->generation == generation &&
+        mapping->width == width && mapping->height == height)
+        return;
+
+    // 无法识别捕获区域时退化为原来的行为：源位于桌面原点、尺寸与源相同
+    if (!resolve_capture_rect(parent, &rect)) {
+        rect.x = 0.0f;
+        rect.y = 0.0f;
+        rect.width = (float)width;
+        rect.height = (float)height;
+    }
+
+    mapping_set_region(mapping, rect.x, rect.y, rect.width, rect.height,
+                       generation, width, height);
+
+    blog(LOG_DEBUG, "[zoom-mapping] capture region %.0fx%.0f at (%.0f, %.0f)",
+         rect.width, rect.height, rect.x, rect.y);
+}
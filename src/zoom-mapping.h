@@ -0,0 +1,14 @@
+#ifndef ZOOM_MAPPING_H
+#define ZOOM_MAPPING_H
+
+#include <stdint.h>
+#include <obs-module.h>
+#include "zoom-tracking.h"
+
+// 捕获区域的解析（依赖libobs和显示器枚举），映射本身见 zoom-tracking.h
+
+// 检查布局代号和源尺寸，变化时重新解析父源的捕获区域，否则立即返回
+void mapping_refresh(struct tracking_mapping *mapping, obs_source_t *parent,
+                     uint32_t width, uint32_t height);
+
+#endif // ZOOM_MAPPING_H
@@ -0,0 +1,205 @@
+#include "zoom-motion.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MOTION_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang需要为AVX2函数单独打开指令集，MSVC可以直接使用内建函数
+#if defined(MOTION_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MOTION_TARGET_SSE2 __attribute__((target("sse2")))
+#define MOTION_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MOTION_TARGET_SSE2
+#define MOTION_TARGET_AVX2
+#endif
+
+static uint64_t sad_scalar(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < size; i++)
+        sum += (uint64_t)(a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]);
+    return sum;
+}
+
+#ifdef MOTION_X86
+// psadbw：每16字节得到两个64位部分和
+MOTION_TARGET_SSE2
+static uint64_t sad_sse2(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+
+    uint64_t parts[2];
+    _mm_storeu_si128((__m128i *)parts, acc);
+    return parts[0] + parts[1] + sad_scalar(a + i, b + i, size - i);
+}
+
+MOTION_TARGET_AVX2
+static uint64_t sad_avx2(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+
+    uint64_t parts[4];
+    _mm256_storeu_si256((__m256i *)parts, acc);
+    return parts[0] + parts[1] + parts[2] + parts[3] + sad_sse2(a + i, b + i, size - i);
+}
+
+static bool cpu_has_avx2(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // 还需要操作系统保存YMM寄存器（OSXSAVE且XCR0的SSE/AVX位均已启用）
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+bool motion_kernel_supported(int kernel)
+{
+    switch (kernel) {
+        case MOTION_KERNEL_SCALAR:
+            return true;
+#ifdef MOTION_X86
+        case MOTION_KERNEL_SSE2:
+            // x86-64 始终支持SSE2；32位构建假定目标CPU不早于SSE2
+            return true;
+        case MOTION_KERNEL_AVX2:
+            return cpu_has_avx2();
+#endif
+        default:
+            return false;
+    }
+}
+
+int motion_best_kernel(void)
+{
+    static int best = -1;
+
+    // 检测结果对所有线程都相同，重复检测也只是写入同一个值
+    if (best < 0) {
+        best = motion_kernel_supported(MOTION_KERNEL_AVX2) ? MOTION_KERNEL_AVX2
+             : motion_kernel_supported(MOTION_KERNEL_SSE2) ? MOTION_KERNEL_SSE2
+             : MOTION_KERNEL_SCALAR;
+    }
+    return best;
+}
+
+uint64_t motion_sad(int kernel, const uint8_t *a, const uint8_t *b, size_t size)
+{
+    switch (kernel) {
+#ifdef MOTION_X86
+        case MOTION_KERNEL_AVX2:
+            return sad_avx2(a, b, size);
+        case MOTION_KERNEL_SSE2:
+            return sad_sse2(a, b, size);
+#endif
+        case MOTION_KERNEL_SCALAR:
+        default:
+            return sad_scalar(a, b, size);
+    }
+}
+
+void motion_tile_energy(int kernel, const uint8_t *current, const uint8_t *previous,
+                        uint32_t width, uint32_t height, uint32_t stride,
+                        int cols, int rows, uint64_t *energy)
+{
+    uint32_t bounds[MOTION_MAX_TILES + 1];
+
+    if (cols < 1 || rows < 1 || cols * rows > MOTION_MAX_TILES)
+        return;
+
+    // 分块的列边界（像素）
+    for (int c = 0; c <= cols; c++)
+        bounds[c] = (uint32_t)((uint64_t)width * (uint64_t)c / (uint64_t)cols);
+
+    for (int r = 0; r < rows; r++) {
+        uint32_t y0 = (uint32_t)((uint64_t)height * (uint64_t)r / (uint64_t)rows);
+        uint32_t y1 = (uint32_t)((uint64_t)height * (uint64_t)(r + 1) / (uint64_t)rows);
+        uint64_t *row_energy = energy + (size_t)r * (size_t)cols;
+
+        for (int c = 0; c < cols; c++)
+            row_energy[c] = 0;
+
+        for (uint32_t y = y0; y < y1; y++) {
+            const uint8_t *cur = current + (size_t)y * stride;
+            const uint8_t *prev = previous + (size_t)y * stride;
+
+            for (int c = 0; c < cols; c++) {
+                size_t offset = (size_t)bounds[c] * 4;
+                size_t size = (size_t)(bounds[c + 1] - bounds[c]) * 4;
+                row_energy[c] += motion_sad(kernel, cur + offset, prev + offset, size);
+            }
+        }
+    }
+}
+
+bool motion_find_focus(const uint64_t *energy, int cols, int rows, uint64_t threshold,
+                       float *focus_x, float *focus_y)
+{
+    int best = -1;
+    uint64_t best_energy = 0;
+
+    for (int i = 0; i < cols * rows; i++) {
+        if (energy[i] > best_energy) {
+            best_energy = energy[i];
+            best = i;
+        }
+    }
+
+    if (best < 0 || best_energy < threshold)
+        return false;
+
+    // 在最大分块的3x3邻域内按能量加权，得到分块以下精度的中心
+    int best_col = best % cols;
+    int best_row = best / cols;
+    double sum = 0.0, sum_x = 0.0, sum_y = 0.0;
+
+    for (int r = best_row - 1; r <= best_row + 1; r++) {
+        if (r < 0 || r >= rows)
+            continue;
+        for (int c = best_col - 1; c <= best_col + 1; c++) {
+            if (c < 0 || c >= cols)
+                continue;
+            double e = (double)energy[r * cols + c];
+            sum += e;
+            sum_x += e * ((double)c + 0.5);
+            sum_y += e * ((double)r + 0.5);
+        }
+    }
+
+    *focus_x = (float)(sum_x / sum / (double)cols);
+    *focus_y = (float)(sum_y / sum / (double)rows);
+    return true;
+}
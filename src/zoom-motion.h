@@ -0,0 +1,36 @@
+#ifndef ZOOM_MOTION_H
+#define ZOOM_MOTION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 逐字节绝对差之和（SAD）的实现
+#define MOTION_KERNEL_SCALAR 0
+#define MOTION_KERNEL_SSE2 1
+#define MOTION_KERNEL_AVX2 2
+
+// 运动能量网格的最大分块数
+#define MOTION_MAX_TILES 1024
+
+// 当前CPU可用的最快实现（只检测一次）
+int motion_best_kernel(void);
+
+// 指定实现是否可用（测试中用于逐一比较各实现）
+bool motion_kernel_supported(int kernel);
+
+// 计算两段字节的绝对差之和
+uint64_t motion_sad(int kernel, const uint8_t *a, const uint8_t *b, size_t size);
+
+// 计算两帧RGBA图像（像素紧密排列，行距stride字节）每个分块的运动能量（SAD），
+// 按行优先写入energy[cols * rows]
+void motion_tile_energy(int kernel, const uint8_t *current, const uint8_t *previous,
+                        uint32_t width, uint32_t height, uint32_t stride,
+                        int cols, int rows, uint64_t *energy);
+
+// 找出最活跃的区域：取能量最大的分块，与相邻分块按能量加权求中心（0-1范围）
+// 最大能量低于threshold（视为噪声）时返回false
+bool motion_find_focus(const uint64_t *energy, int cols, int rows, uint64_t threshold,
+                       float *focus_x, float *focus_y);
+
+#endif // ZOOM_MOTION_H
@@ -0,0 +1,212 @@
+#include "zoom-recorder.h"
+#include <obs-module.h>
+#include <util/platform.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 把缓冲区中已发布的记录直接从环形缓冲区写入文件（仅写入线程调用）
+static void drain(struct recorder_data *recorder)
+{
+    unsigned long tail = (unsigned long)recorder->tail;
+    unsigned long head = (unsigned long)os_atomic_load_long(&recorder->head);
+
+    if (tail == head)
+        return;
+
+    // 槽位在tail前移之前不会被覆盖，可以直接从环形缓冲区写出，不必复制
+    while (tail != head) {
+        size_t start = tail & RECORD_RING_MASK;
+        size_t count = head - tail;
+        if (count > RECORD_RING_SIZE - start)
+            count = RECORD_RING_SIZE - start;
+
+        fwrite(&recorder->ring[start], sizeof(struct zoom_log_record), count, recorder->file);
+        tail += (unsigned long)count;
+
+        os_atomic_set_long(&recorder->tail, (long)tail);
+        os_atomic_add_long(&recorder->written, (long)count);
+    }
+    fflush(recorder->file);
+}
+
+static void *recorder_thread(void *param)
+{
+    struct recorder_data *recorder = param;
+
+    os_set_thread_name("zoom-filter: recorder");
+
+    while (!os_atomic_load_bool(&recorder->stop)) {
+        os_event_timedwait(recorder->event, (unsigned long)(RECORD_FLUSH_INTERVAL / 1000000));
+        drain(recorder);
+    }
+
+    // 停止前写完剩余记录
+    drain(recorder);
+    return NULL;
+}
+
+bool recorder_start(struct recorder_data *recorder, const char *path,
+                    uint64_t frame_interval, uint64_t start_time)
+{
+    struct zoom_log_header header;
+
+    recorder_stop(recorder);
+
+    if (!path || !*path)
+        return false;
+
+    recorder->file = os_fopen(path, "wb");
+    if (!recorder->file) {
+        blog(LOG_WARNING, "[zoom-recorder] failed to open '%s' for writing", path);
+        return false;
+    }
+
+    zoom_log_header_init(&header, frame_interval, start_time);
+    if (fwrite(&header, sizeof(header), 1, recorder->file) != 1 ||
+        os_event_init(&recorder->event, OS_EVENT_TYPE_AUTO) != 0) {
+        fclose(recorder->file);
+        recorder->file = NULL;
+        return false;
+    }
+
+    recorder->head = 0;
+    recorder->tail = 0;
+    recorder->dropped = 0;
+    recorder->written = 0;
+    os_atomic_set_bool(&recorder->stop, false);
+
+    if (pthread_create(&recorder->thread, NULL, recorder_thread, recorder) != 0) {
+        blog(LOG_ERROR, "[zoom-recorder] failed to start writer thread");
+        os_event_destroy(recorder->event);
+        recorder->event = NULL;
+        fclose(recorder->file);
+        recorder->file = NULL;
+        return false;
+    }
+
+    recorder->running = true;
+    blog(LOG_INFO, "[zoom-recorder] recording to '%s'", path);
+    return true;
+}
+
+void recorder_stop(struct recorder_data *recorder)
+{
+    if (!recorder->running)
+        return;
+
+    os_atomic_set_bool(&recorder->stop, true);
+    os_event_signal(recorder->event);
+    pthread_join(recorder->thread, NULL);
+    os_event_destroy(recorder->event);
+    recorder->event = NULL;
+    fclose(recorder->file);
+    recorder->file = NULL;
+    recorder->running = false;
+
+    long dropped = os_atomic_load_long(&recorder->dropped);
+    blog(dropped ? LOG_WARNING : LOG_INFO,
+         "[zoom-recorder] recording stopped: %ld frames written, %ld dropped",
+         os_atomic_load_long(&recorder->written), dropped);
+}
+
+bool recorder_push(struct recorder_data *recorder, const struct zoom_log_record *record)
+{
+    unsigned long head = (unsigned long)recorder->head;
+    unsigned long tail = (unsigned long)os_atomic_load_long(&recorder->tail);
+
+    if (!recorder->running)
+        return false;
+    if (head - tail >= RECORD_RING_SIZE) {
+        os_atomic_inc_long(&recorder->dropped);
+        return false;
+    }
+
+    recorder->ring[head & RECORD_RING_MASK] = *record;
+
+    // 先写内容再发布序号，写入线程看到新的head时内容已经完整
+    os_atomic_set_long(&recorder->head, (long)(head + 1));
+
+    // 刚好达到一半时唤醒写入线程，其余时候由定时等待落盘，不必每帧发信号
+    if (head + 1 - tail == RECORD_RING_SIZE / 2)
+        os_event_signal(recorder->event);
+    return true;
+}
+
+bool replay_file_open(struct replay_file *file, const char *path)
+{
+    file->data = NULL;
+    file->size = 0;
+
+    if (!path || !*path)
+        return false;
+
+#ifdef _WIN32
+    wchar_t *wpath = NULL;
+    LARGE_INTEGER size;
+
+    if (!os_utf8_to_wcs_ptr(path, 0, &wpath))
+        return false;
+    HANDLE handle = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    bfree(wpath);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    // 映射视图会保持映射对象有效，句柄可以立即关闭
+    HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (!mapping)
+        return false;
+    file->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!file->data)
+        return false;
+    file->size = (size_t)size.QuadPart;
+#else
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // 映射建立后文件描述符不再需要
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+    file->data = data;
+    file->size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void replay_file_close(struct replay_file *file)
+{
+    if (!file->data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(file->data);
+#else
+    munmap((void *)file->data, file->size);
+#endif
+    file->data = NULL;
+    file->size = 0;
+}
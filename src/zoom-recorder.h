@@ -0,0 +1,53 @@
+#ifndef ZOOM_RECORDER_H
+#define ZOOM_RECORDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <util/threading.h>
+#include "zoom-replay.h"
+
+// 录制环形缓冲区大小（必须是2的幂，60fps下约17秒）
+#define RECORD_RING_SIZE 1024
+#define RECORD_RING_MASK (RECORD_RING_SIZE - 1)
+
+// 写入线程的最长等待时间(ns)，缓冲区未满一半时也会按此间隔落盘
+#define RECORD_FLUSH_INTERVAL 250000000ULL
+
+// 轨迹录制：渲染线程每帧只写入环形缓冲区，写入线程在后台追加到日志文件
+struct recorder_data {
+    // 单生产者/单消费者环形缓冲区：渲染线程写入，写入线程读取
+    struct zoom_log_record ring[RECORD_RING_SIZE];
+    volatile long head;     // 下一个写入位置（仅渲染线程修改）
+    volatile long tail;     // 下一个读取位置（仅写入线程修改）
+    volatile long dropped;  // 缓冲区满时丢弃的记录数
+    volatile long written;  // 已写入文件的记录数
+
+    FILE *file;
+    pthread_t thread;
+    os_event_t *event;
+    volatile bool stop;
+    bool running;
+};
+
+// 开始录制到指定文件（覆盖已有文件），失败时返回false
+bool recorder_start(struct recorder_data *recorder, const char *path,
+                    uint64_t frame_interval, uint64_t start_time);
+
+// 停止录制，写完缓冲区中剩余的记录后关闭文件
+void recorder_stop(struct recorder_data *recorder);
+
+// 追加一帧（仅渲染线程调用，不阻塞），缓冲区满时返回false
+bool recorder_push(struct recorder_data *recorder, const struct zoom_log_record *record);
+
+// 只读映射的日志文件
+struct replay_file {
+    const void *data;
+    size_t size;
+};
+
+// 映射/解除映射日志文件
+bool replay_file_open(struct replay_file *file, const char *path);
+void replay_file_close(struct replay_file *file);
+
+#endif // ZOOM_RECORDER_H
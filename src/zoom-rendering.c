@@ -1,33 +1,34 @@
 #include "zoom-rendering.h"
 #include <graphics/vec4.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
+#include "zoom-sampler.h"
+
+// 光标最新采样早于此时间视为静止，静止时绘制位置是准确的，不计入采样年龄
+#define CURSOR_IDLE_AGE_NS 100000000ULL    // 100ms
+
+static const char *latch_name = "tracking_get_latched_center";
+static const char *draw_name = "zoom_draw";
 
 // 初始化渲染数据
 void rendering_init(struct rendering_data *rendering,
+                  obs_source_t *context,
                   struct tracking_data *tracking,
-                  struct smoothing_data *smoothing)
+                  struct smoothing_data *smoothing,
+                  struct zoom_stats *stats)
 {
+    rendering->context = context;
     rendering->tracking = tracking;
     rendering->smoothing = smoothing;
+    rendering->stats = stats;
+    rendering->mode = RENDER_MODE_MATRIX;
 }
 
-// 执行渲染
-void rendering_render(struct rendering_data *rendering,
-                    obs_source_t *target,
-                    gs_effect_t *effect)
+// 整个源按矩阵绕中心点缩放，超出部分由GPU裁掉
+static void render_matrix(obs_source_t *target, uint32_t width, uint32_t height,
+                          float scale, float center_x, float center_y)
 {
-    if (!rendering->tracking || !rendering->smoothing || !target) {
-        return;
-    }
-    
-    // 获取源的尺寸
-    uint32_t width = obs_source_get_width(target);
-    uint32_t height = obs_source_get_height(target);
-    
-    if (!width || !height) {
-        obs_source_skip_video_filter(target);
-        return;
-    }
-    
     // 准备清空画面
     struct vec4 clear_color;
     vec4_zero(&clear_color);
@@ -36,13 +37,6 @@ void rendering_render(struct rendering_data *rendering,
     // 设置正交投影（2D渲染）
     gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
     
-    // 获取当前缩放比例
-    float scale = rendering->smoothing->current_scale;
-    
-    // 获取缩放中心点
-    float center_x, center_y;
-    tracking_get_center(rendering->tracking, (float)width, (float)height, &center_x, &center_y);
-    
     // 执行变换
     gs_matrix_push();
     
@@ -61,3 +55,88 @@ void rendering_render(struct rendering_data *rendering,
     // 恢复矩阵
     gs_matrix_pop();
 }
+
+// 与矩阵模式相同，一次绘制整个源、超出部分由GPU裁掉，但变换由限制在源范围内的
+// 可见区域决定：平移到边缘或超调到1倍以下时不会露出源外的黑边
+static void render_viewport(obs_source_t *target, uint32_t width, uint32_t height,
+                            float scale, float center_x, float center_y)
+{
+    struct zoom_viewport viewport;
+    transform_compute_viewport(width, height, scale, center_x, center_y, &viewport);
+    
+    struct vec4 clear_color;
+    vec4_zero(&clear_color);
+    gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+    
+    gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+    
+    // 可见区域的左上角移到原点，再放大到整个输出
+    gs_matrix_push();
+    gs_matrix_scale3f((float)width / viewport.width, (float)height / viewport.height, 1.0f);
+    gs_matrix_translate3f(-viewport.left, -viewport.top, 0.0f);
+    obs_source_video_render(target);
+    gs_matrix_pop();
+}
+
+bool rendering_is_identity(const struct rendering_data *rendering)
+{
+    return transform_is_identity(rendering->smoothing);
+}
+
+// 执行渲染
+void rendering_render(struct rendering_data *rendering,
+                    obs_source_t *target,
+                    gs_effect_t *effect)
+{
+    if (!rendering->tracking || !rendering->smoothing || !target) {
+        return;
+    }
+    
+    // 直通：未缩放时不做任何绘制工作，交给下一个滤镜/源
+    if (rendering_is_identity(rendering)) {
+        os_atomic_inc_long(&rendering->stats->live.identity_frames);
+        obs_source_skip_video_filter(rendering->context);
+        return;
+    }
+    
+    // 获取源的尺寸
+    uint32_t width = obs_source_get_width(target);
+    uint32_t height = obs_source_get_height(target);
+    
+    if (!width || !height) {
+        obs_source_skip_video_filter(rendering->context);
+        return;
+    }
+    
+    os_atomic_inc_long(&rendering->stats->live.transform_frames);
+    
+    // 获取当前缩放比例
+    float scale = rendering->smoothing->current_scale;
+    
+    // 获取缩放中心点，延迟锁存：尽量晚地重新读取光标，缩短光标到画面的延迟
+    float center_x, center_y;
+    uint64_t draw_time = os_gettime_ns();
+    profile_start(latch_name);
+    tracking_get_latched_center(rendering->tracking, (float)width, (float)height,
+                                draw_time, &center_x, &center_y);
+    profile_end(latch_name);
+    os_atomic_set_long(&rendering->stats->live.center_x, lroundf(center_x));
+    os_atomic_set_long(&rendering->stats->live.center_y, lroundf(center_y));
+    
+    // 记录绘制时所用光标数据的年龄
+    if (rendering->tracking->latch_active) {
+        uint64_t sample_time = cursor_sampler_latest_timestamp();
+        if (sample_time && sample_time <= draw_time &&
+            draw_time - sample_time < CURSOR_IDLE_AGE_NS) {
+            histogram_record(&rendering->stats->cursor_age, draw_time - sample_time);
+        }
+    }
+    
+    profile_start(draw_name);
+    if (rendering->mode == RENDER_MODE_VIEWPORT) {
+        render_viewport(target, width, height, scale, center_x, center_y);
+    } else {
+        render_matrix(target, width, height, scale, center_x, center_y);
+    }
+    profile_end(draw_name);
+}
@@ -4,21 +4,35 @@
 #include <obs-module.h>
 #include "zoom-tracking.h"
 #include "zoom-smoothing.h"
+#include "zoom-transform.h"
+#include "zoom-stats.h"
+
+// 渲染模式
+#define RENDER_MODE_MATRIX 0        // 整个源按矩阵缩放（旧行为）
+#define RENDER_MODE_VIEWPORT 1      // 同样按矩阵缩放，但可见区域限制在源范围内
 
 // 渲染状态结构体
 struct rendering_data {
+    obs_source_t *context;              // 滤镜自身（直通时跳过滤镜用）
     struct tracking_data *tracking;     // 跟踪数据引用
     struct smoothing_data *smoothing;   // 平滑数据引用
+    struct zoom_stats *stats;           // 统计引用（渲染路径计数、光标年龄）
+    int mode;                           // 渲染模式
 };
 
 // 初始化渲染数据
 void rendering_init(struct rendering_data *rendering,
+                  obs_source_t *context,
                   struct tracking_data *tracking,
-                  struct smoothing_data *smoothing);
+                  struct smoothing_data *smoothing,
+                  struct zoom_stats *stats);
 
 // 执行渲染
 void rendering_render(struct rendering_data *rendering,
                     obs_source_t *target,
                     gs_effect_t *effect);
 
+// 当前状态是否为恒等变换（未缩放且没有进行中的过渡）
+bool rendering_is_identity(const struct rendering_data *rendering);
+
 #endif // ZOOM_RENDERING_H
@@ -0,0 +1,90 @@
+#include "zoom-replay.h"
+#include <string.h>
+
+void zoom_log_header_init(struct zoom_log_header *header, uint64_t frame_interval,
+                          uint64_t start_time)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, ZOOM_LOG_MAGIC, 4);
+    header->version = ZOOM_LOG_VERSION;
+    header->record_size = sizeof(struct zoom_log_record);
+    header->frame_interval = frame_interval;
+    header->start_time = start_time;
+}
+
+bool replay_attach(struct replay_data *replay, const void *data, size_t size)
+{
+    const struct zoom_log_header *header = data;
+
+    memset(replay, 0, sizeof(*replay));
+
+    if (!data || size < sizeof(*header))
+        return false;
+    if (memcmp(header->magic, ZOOM_LOG_MAGIC, 4) != 0 ||
+        header->version != ZOOM_LOG_VERSION ||
+        header->record_size != sizeof(struct zoom_log_record))
+        return false;
+
+    // 末尾不完整的记录（写入中途中断）直接忽略
+    size_t count = (size - sizeof(*header)) / sizeof(struct zoom_log_record);
+    if (count == 0)
+        return false;
+
+    replay->records = (const struct zoom_log_record *)(header + 1);
+    replay->count = count;
+    replay->frame_interval = header->frame_interval;
+    return true;
+}
+
+void replay_start(struct replay_data *replay, uint64_t current_time)
+{
+    replay->cursor = 0;
+    replay->start = current_time;
+}
+
+// 最后一条frame_ts不晚于t的记录（第一条总是满足）
+static size_t find_record(const struct replay_data *replay, uint64_t t)
+{
+    size_t lo = 0;
+    size_t hi = replay->count;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (replay->records[mid].frame_ts <= t)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+const struct zoom_log_record *replay_lookup(struct replay_data *replay, uint64_t current_time)
+{
+    if (!replay->count)
+        return NULL;
+    if (!replay->start)
+        replay_start(replay, current_time);
+
+    // 把当前时间换算到日志的时间轴上
+    uint64_t elapsed = current_time > replay->start ? current_time - replay->start : 0;
+    uint64_t t = replay->records[0].frame_ts + elapsed;
+
+    // 顺序播放时每帧只前移一两条；时间倒退或大幅前跳时二分查找
+    size_t i = replay->cursor;
+    uint64_t ts = replay->records[i].frame_ts;
+    if (ts > t || (replay->frame_interval &&
+                   t - ts > replay->frame_interval * REPLAY_SCAN_FRAMES)) {
+        i = find_record(replay, t);
+    } else {
+        while (i + 1 < replay->count && replay->records[i + 1].frame_ts <= t)
+            i++;
+    }
+
+    replay->cursor = i;
+    return &replay->records[i];
+}
+
+bool replay_finished(const struct replay_data *replay)
+{
+    return replay->count == 0 || replay->cursor + 1 >= replay->count;
+}
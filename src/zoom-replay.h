@@ -0,0 +1,67 @@
+#ifndef ZOOM_REPLAY_H
+#define ZOOM_REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 轨迹日志格式：文件头之后紧跟定长记录，按帧时间递增排列
+// 字段按本机字节序存储，记录只追加，崩溃后末尾不完整的记录会被忽略
+#define ZOOM_LOG_MAGIC "ZLOG"
+#define ZOOM_LOG_VERSION 1
+
+// 本帧处理过的输入事件（位掩码）
+#define ZOOM_LOG_EVENT_IN_DOWN 0x01
+#define ZOOM_LOG_EVENT_IN_UP 0x02
+#define ZOOM_LOG_EVENT_OUT_DOWN 0x04
+#define ZOOM_LOG_EVENT_OUT_UP 0x08
+#define ZOOM_LOG_EVENT_RESET 0x10
+
+// 回放时前跳超过这么多帧就改用二分查找，而不是逐条前移
+#define REPLAY_SCAN_FRAMES 8
+
+struct zoom_log_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;   // sizeof(struct zoom_log_record)，用于检查格式
+    uint32_t reserved;
+    uint64_t frame_interval; // 录制时的帧间隔(ns)
+    uint64_t start_time;     // 录制开始时的视频帧时间(ns)
+};
+
+// 一帧的缩放状态（24字节，无填充）
+struct zoom_log_record {
+    uint64_t frame_ts;      // 视频帧时间(ns)
+    float scale;            // 当前缩放值
+    float center_x;         // 缩放中心（源内相对坐标，0-1）
+    float center_y;
+    uint32_t events;        // ZOOM_LOG_EVENT_*
+};
+
+// 回放状态：记录直接指向映射的文件，不复制
+struct replay_data {
+    const struct zoom_log_record *records;
+    size_t count;
+    uint64_t frame_interval;
+    size_t cursor;          // 上一次查找到的记录
+    uint64_t start;         // 回放开始时的视频帧时间，0表示尚未开始
+};
+
+// 填写文件头
+void zoom_log_header_init(struct zoom_log_header *header, uint64_t frame_interval,
+                          uint64_t start_time);
+
+// 检查日志内容并关联到回放状态，格式不符或没有记录时返回false
+bool replay_attach(struct replay_data *replay, const void *data, size_t size);
+
+// 从当前时间开始回放（之后的查找以此为第一条记录的时间）
+void replay_start(struct replay_data *replay, uint64_t current_time);
+
+// 查找当前时间对应的记录（不晚于该时间的最后一条），顺序播放时均摊O(1)
+// 超过最后一条后一直返回最后一条
+const struct zoom_log_record *replay_lookup(struct replay_data *replay, uint64_t current_time);
+
+// 是否已播放到最后一条记录
+bool replay_finished(const struct replay_data *replay);
+
+#endif // ZOOM_REPLAY_H
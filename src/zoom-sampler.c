@@ -0,0 +1,393 @@
+#include "zoom-sampler.h"
+#include "zoom-cursor.h"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <errno.h>
+#include <string.h>
+
+// 环形缓冲区大小（必须是2的幂）
+#define SAMPLE_RING_SIZE 128
+#define SAMPLE_RING_MASK (SAMPLE_RING_SIZE - 1)
+
+// 轮询间隔：无事件后端时的采样周期，以及事件模式下的空闲唤醒周期
+#define POLL_INTERVAL_NS 4000000ULL     // 4ms ≈ 250Hz
+#define IDLE_TIMEOUT_NS 100000000ULL    // 100ms
+
+// 单生产者/多消费者环形缓冲区，每个槽位用序号做seqlock：
+// 序号为奇数表示正在写入，读者发现序号变化时重读
+struct sample_slot {
+    volatile long seq;
+    float x;
+    float y;
+    uint64_t timestamp;
+};
+
+struct sample_ring {
+    struct sample_slot slots[SAMPLE_RING_SIZE];
+    volatile long head;    // 下一个写入位置（单调递增）
+};
+
+static struct sample_ring ring = {0};
+
+// 显示器布局缓存：采样线程在布局变化时刷新，读者比较代号决定是否重新读取
+static pthread_mutex_t monitor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct cursor_monitor monitors[CURSOR_MAX_MONITORS];
+static int monitor_count = 0;
+static volatile long monitor_generation = 0;
+
+// 每个视频帧缓存一次的光标位置，所有滤镜实例共享。读者都在图形线程，
+// 缓存是普通变量不加锁；采样线程重启后代号变化，旧缓存随之失效
+static volatile long sampler_session = 0;
+static uint64_t frame_key = 0;
+static long frame_session = 0;
+static struct cursor_sample frame_sample;
+static bool frame_valid = false;
+
+// 缩放手势累计总量，采样线程写入，读者按差值读取；
+// 每次并入新输入后增加版本号，读者只在版本号变化时才加锁
+static pthread_mutex_t gesture_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct gesture_reader gesture_total = {0};
+static volatile long gesture_generation = 0;
+
+static pthread_mutex_t sampler_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t sampler_thread;
+static os_event_t *stop_event = NULL;
+static long sampler_refs = 0;
+
+// 生产者写入一个采样（仅采样线程调用）
+static void ring_push(float x, float y, uint64_t timestamp)
+{
+    unsigned long head = (unsigned long)os_atomic_load_long(&ring.head);
+    struct sample_slot *slot = &ring.slots[head & SAMPLE_RING_MASK];
+
+    os_atomic_inc_long(&slot->seq);
+    slot->x = x;
+    slot->y = y;
+    slot->timestamp = timestamp;
+    os_atomic_inc_long(&slot->seq);
+
+    os_atomic_set_long(&ring.head, (long)(head + 1));
+}
+
+// 读取指定序号的采样，被生产者覆盖时返回false
+static bool ring_read(unsigned long index, struct cursor_sample *sample)
+{
+    const struct sample_slot *slot = &ring.slots[index & SAMPLE_RING_MASK];
+
+    for (int retry = 0; retry < 4; retry++) {
+        long seq = os_atomic_load_long(&slot->seq);
+        if (seq & 1)
+            continue;
+
+        sample->x = slot->x;
+        sample->y = slot->y;
+        sample->timestamp = slot->timestamp;
+
+        if (os_atomic_load_long(&slot->seq) == seq)
+            return true;
+    }
+
+    return false;
+}
+
+// 重新枚举显示器（仅采样线程调用，与光标查询共用同一个后端连接）
+static void refresh_monitors(void)
+{
+    struct cursor_monitor list[CURSOR_MAX_MONITORS];
+    int count = cursor_backend_get_monitors(list, CURSOR_MAX_MONITORS);
+
+    pthread_mutex_lock(&monitor_mutex);
+    memcpy(monitors, list, sizeof(*list) * (size_t)count);
+    monitor_count = count;
+    pthread_mutex_unlock(&monitor_mutex);
+
+    os_atomic_inc_long(&monitor_generation);
+    blog(LOG_INFO, "[zoom-sampler] monitor layout updated (%d monitors)", count);
+}
+
+// 把后端累计的手势输入并入总量（仅采样线程调用）
+static void collect_gesture(void)
+{
+    struct cursor_gesture gesture;
+
+    if (!cursor_backend_take_gesture(&gesture))
+        return;
+
+    pthread_mutex_lock(&gesture_mutex);
+    for (int i = 0; i < CURSOR_MOD_COUNT; i++)
+        gesture_total.wheel[i] += gesture.wheel[i];
+    gesture_total.pinch += gesture.pinch;
+    gesture_total.generation = os_atomic_inc_long(&gesture_generation);
+    pthread_mutex_unlock(&gesture_mutex);
+}
+
+static void *sampler_thread_proc(void *param)
+{
+    UNUSED_PARAMETER(param);
+    os_set_thread_name("zoom-filter: cursor sampler");
+
+    bool events = cursor_backend_has_events();
+    float last_x = 0.0f, last_y = 0.0f;
+    uint64_t last_push = 0;
+    bool have_last = false;
+
+    while (os_event_try(stop_event) == EAGAIN) {
+        uint64_t now;
+        float x, y;
+
+        if (events) {
+            // 事件模式：移动时立即唤醒，空闲时低频唤醒以检查退出
+            cursor_backend_wait_motion(IDLE_TIMEOUT_NS);
+        } else {
+            os_sleepto_ns(os_gettime_ns() + POLL_INTERVAL_NS);
+        }
+
+        if (cursor_backend_monitors_changed())
+            refresh_monitors();
+        collect_gesture();
+
+        if (!cursor_backend_query(&x, &y))
+            continue;
+
+        now = os_gettime_ns();
+        if (have_last && x == last_x && y == last_y)
+            continue;
+
+        // 静止一段时间后重新移动：先补一个静止位置的采样，
+        // 避免插值把这次移动摊到整个静止区间上
+        if (have_last && now - last_push > 2 * POLL_INTERVAL_NS)
+            ring_push(last_x, last_y, now - POLL_INTERVAL_NS);
+
+        ring_push(x, y, now);
+        last_x = x;
+        last_y = y;
+        last_push = now;
+        have_last = true;
+    }
+
+    return NULL;
+}
+
+bool cursor_sampler_acquire(void)
+{
+    bool success = true;
+
+    pthread_mutex_lock(&sampler_mutex);
+    if (sampler_refs == 0) {
+        if (!cursor_backend_acquire()) {
+            cursor_backend_release();
+            success = false;
+            goto unlock;
+        }
+
+        if (os_event_init(&stop_event, OS_EVENT_TYPE_MANUAL) != 0 ||
+            pthread_create(&sampler_thread, NULL, sampler_thread_proc, NULL) != 0) {
+            blog(LOG_ERROR, "[zoom-sampler] failed to start cursor sampler thread");
+            os_event_destroy(stop_event);
+            stop_event = NULL;
+            cursor_backend_release();
+            success = false;
+            goto unlock;
+        }
+    }
+    sampler_refs++;
+
+unlock:
+    pthread_mutex_unlock(&sampler_mutex);
+    return success;
+}
+
+void cursor_sampler_release(void)
+{
+    pthread_mutex_lock(&sampler_mutex);
+    if (sampler_refs > 0 && --sampler_refs == 0) {
+        os_event_signal(stop_event);
+        pthread_join(sampler_thread, NULL);
+        os_event_destroy(stop_event);
+        stop_event = NULL;
+        cursor_backend_release();
+        os_atomic_inc_long(&sampler_session);
+    }
+    pthread_mutex_unlock(&sampler_mutex);
+}
+
+bool cursor_sampler_get(uint64_t timestamp, struct cursor_sample *sample)
+{
+    unsigned long head = (unsigned long)os_atomic_load_long(&ring.head);
+    struct cursor_sample newer, older;
+
+    if (head == 0 || !ring_read(head - 1, &newer))
+        return false;
+
+    // 请求时间晚于最新采样：直接返回最新位置
+    if (timestamp >= newer.timestamp) {
+        *sample = newer;
+        return true;
+    }
+
+    // 向前查找包围该时间戳的两个采样并线性插值
+    unsigned long count = head < SAMPLE_RING_SIZE - 1 ? head : SAMPLE_RING_SIZE - 1;
+    for (unsigned long i = 2; i <= count; i++) {
+        if (!ring_read(head - i, &older))
+            break;
+
+        if (older.timestamp <= timestamp) {
+            uint64_t span = newer.timestamp - older.timestamp;
+            float t = span ? (float)(timestamp - older.timestamp) / (float)span : 1.0f;
+
+            sample->x = older.x + (newer.x - older.x) * t;
+            sample->y = older.y + (newer.y - older.y) * t;
+            sample->timestamp = timestamp;
+            return true;
+        }
+        newer = older;
+    }
+
+    // 请求时间早于所有保留的采样：返回最旧的一个
+    *sample = newer;
+    return true;
+}
+
+uint64_t cursor_sampler_latest_timestamp(void)
+{
+    unsigned long head = (unsigned long)os_atomic_load_long(&ring.head);
+    struct cursor_sample newest;
+
+    if (head == 0 || !ring_read(head - 1, &newest))
+        return 0;
+    return newest.timestamp;
+}
+
+double cursor_sampler_sample_rate(uint64_t now, uint64_t window_ns)
+{
+    unsigned long head = (unsigned long)os_atomic_load_long(&ring.head);
+    unsigned long count = head < SAMPLE_RING_SIZE - 1 ? head : SAMPLE_RING_SIZE - 1;
+    struct cursor_sample sample;
+    uint64_t newest = 0, oldest = 0;
+    unsigned long found = 0;
+
+    for (unsigned long i = 1; i <= count; i++) {
+        if (!ring_read(head - i, &sample) || sample.timestamp + window_ns < now)
+            break;
+        if (found == 0)
+            newest = sample.timestamp;
+        oldest = sample.timestamp;
+        found++;
+    }
+
+    if (found < 2)
+        return 0.0;
+
+    // 保留的采样不足以覆盖整个窗口时，按实际覆盖的时间计算
+    if (found == count && newest > oldest)
+        return (double)(found - 1) * 1000000000.0 / (double)(newest - oldest);
+    return (double)found * 1000000000.0 / (double)window_ns;
+}
+
+bool cursor_sampler_get_frame(uint64_t timestamp, struct cursor_sample *sample)
+{
+    long session = os_atomic_load_long(&sampler_session);
+
+    if (timestamp != frame_key || session != frame_session) {
+        // 本帧第一个读者负责读取环形缓冲区
+        frame_valid = cursor_sampler_get(timestamp, &frame_sample);
+        frame_key = timestamp;
+        frame_session = session;
+    }
+    if (frame_valid)
+        *sample = frame_sample;
+
+    return frame_valid;
+}
+
+bool cursor_sampler_get_velocity(uint64_t timestamp, uint64_t window_ns,
+                                 float *vx, float *vy)
+{
+    struct cursor_sample now, before;
+
+    if (!window_ns || timestamp < window_ns ||
+        !cursor_sampler_get(timestamp, &now) ||
+        !cursor_sampler_get(timestamp - window_ns, &before))
+        return false;
+
+    float dt = (float)window_ns / 1000000000.0f;
+    *vx = (now.x - before.x) / dt;
+    *vy = (now.y - before.y) / dt;
+    return true;
+}
+
+long cursor_sampler_monitor_generation(void)
+{
+    return os_atomic_load_long(&monitor_generation);
+}
+
+int cursor_sampler_get_monitors(struct cursor_monitor *list, int max)
+{
+    pthread_mutex_lock(&monitor_mutex);
+    int count = monitor_count < max ? monitor_count : max;
+    memcpy(list, monitors, sizeof(*list) * (size_t)count);
+    pthread_mutex_unlock(&monitor_mutex);
+
+    return count;
+}
+
+// 跟踪模块的光标数据源适配
+void cursor_sampler_gesture_sync(struct gesture_reader *reader)
+{
+    pthread_mutex_lock(&gesture_mutex);
+    *reader = gesture_total;
+    pthread_mutex_unlock(&gesture_mutex);
+}
+
+bool cursor_sampler_gesture_read(struct gesture_reader *reader, struct cursor_gesture *delta)
+{
+    bool changed = false;
+
+    if (os_atomic_load_long(&gesture_generation) == reader->generation)
+        return false;
+
+    pthread_mutex_lock(&gesture_mutex);
+    for (int i = 0; i < CURSOR_MOD_COUNT; i++) {
+        delta->wheel[i] = (float)(gesture_total.wheel[i] - reader->wheel[i]);
+        changed |= delta->wheel[i] != 0.0f;
+    }
+    delta->pinch = (float)(gesture_total.pinch - reader->pinch);
+    changed |= delta->pinch != 0.0f;
+    *reader = gesture_total;
+    pthread_mutex_unlock(&gesture_mutex);
+
+    return changed;
+}
+
+static bool source_get_frame(uint64_t timestamp, float *x, float *y)
+{
+    struct cursor_sample sample;
+
+    if (!cursor_sampler_get_frame(timestamp, &sample))
+        return false;
+
+    *x = sample.x;
+    *y = sample.y;
+    return true;
+}
+
+static bool source_get(uint64_t timestamp, float *x, float *y)
+{
+    struct cursor_sample sample;
+
+    if (!cursor_sampler_get(timestamp, &sample))
+        return false;
+
+    *x = sample.x;
+    *y = sample.y;
+    return true;
+}
+
+const struct tracking_cursor cursor_sampler_source = {
+    .acquire = cursor_sampler_acquire,
+    .release = cursor_sampler_release,
+    .get_frame = source_get_frame,
+    .get = source_get,
+    .get_velocity = cursor_sampler_get_velocity,
+};
@@ -0,0 +1,62 @@
+#ifndef ZOOM_SAMPLER_H
+#define ZOOM_SAMPLER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "zoom-cursor.h"
+#include "zoom-tracking.h"
+
+// 光标采样（桌面坐标，像素）
+struct cursor_sample {
+    float x;
+    float y;
+    uint64_t timestamp;    // 采样时间(ns，os_gettime_ns时基)
+};
+
+// 获取/释放后台采样线程（引用计数，首个引用启动线程，最后一个停止）
+bool cursor_sampler_acquire(void);
+void cursor_sampler_release(void);
+
+// 读取插值到指定时间戳的光标位置（无锁、无系统调用，可在渲染线程调用）
+// 尚无任何采样时返回false
+bool cursor_sampler_get(uint64_t timestamp, struct cursor_sample *sample);
+
+// 最新采样的时间戳，尚无采样时返回0（光标静止时不产生新采样）
+uint64_t cursor_sampler_latest_timestamp(void);
+
+// 最近window_ns内的有效采样率(Hz)；光标静止时不产生采样，结果为0
+double cursor_sampler_sample_rate(uint64_t now, uint64_t window_ns);
+
+// 读取当前视频帧的光标位置（timestamp为视频帧时间）：同一时间戳只有第一次调用读取环形缓冲区，
+// 之后的调用（其他滤镜实例、其他视图）直接返回缓存，滤镜实例再多开销也不变。
+// 缓存不加锁，只能在图形线程调用
+bool cursor_sampler_get_frame(uint64_t timestamp, struct cursor_sample *sample);
+
+// 估计指定时间戳处的光标速度（像素/秒），取[timestamp - window_ns, timestamp]区间的平均值
+bool cursor_sampler_get_velocity(uint64_t timestamp, uint64_t window_ns,
+                                 float *vx, float *vy);
+
+// 显示器布局代号，每次布局变化后递增（无锁，可每帧调用）
+long cursor_sampler_monitor_generation(void);
+
+// 复制缓存的显示器列表，返回数量（加锁，只应在代号变化时调用）
+int cursor_sampler_get_monitors(struct cursor_monitor *list, int max);
+
+// 缩放手势的读取位置：采样线程把滚轮和捏合输入累加成总量，每个读者记住自己读到的总量，
+// 每帧只取一次差值，事件再密集每帧也只产生一次缩放
+struct gesture_reader {
+    double wheel[CURSOR_MOD_COUNT];
+    double pinch;
+    long generation;        // 读到的总量对应的版本号，未变化时读取不加锁
+};
+
+// 把读取位置移到当前总量，之前的输入不再返回
+void cursor_sampler_gesture_sync(struct gesture_reader *reader);
+
+// 读取自上次读取以来的手势输入，没有新输入时返回false
+bool cursor_sampler_gesture_read(struct gesture_reader *reader, struct cursor_gesture *delta);
+
+// 以采样线程为后端的光标数据源，供跟踪模块使用
+extern const struct tracking_cursor cursor_sampler_source;
+
+#endif // ZOOM_SAMPLER_H
@@ -0,0 +1,102 @@
+#include "zoom-script.h"
+#include <obs-module.h>
+#include <math.h>
+
+// 读取关键帧时间：数字为秒，文本按"时:分:秒"解析
+static bool read_time(obs_data_t *item, uint64_t *time)
+{
+    obs_data_item_t *field = obs_data_item_byname(item, "time");
+    bool ok = false;
+
+    if (!field)
+        return false;
+
+    switch (obs_data_item_gettype(field)) {
+        case OBS_DATA_NUMBER: {
+            double seconds = obs_data_item_get_double(field);
+            if (seconds >= 0.0 && isfinite(seconds)) {
+                *time = (uint64_t)llround(seconds * 1000000000.0);
+                ok = true;
+            }
+            break;
+        }
+        case OBS_DATA_STRING:
+            ok = timeline_parse_time(obs_data_item_get_string(field), time);
+            break;
+        default:
+            break;
+    }
+
+    obs_data_item_release(&field);
+    return ok;
+}
+
+static bool read_key(obs_data_t *item, struct timeline_key *key)
+{
+    if (!read_time(item, &key->time))
+        return false;
+
+    double duration = obs_data_get_double(item, "duration");
+    if (duration < 0.0 || !isfinite(duration))
+        return false;
+    key->duration = (uint64_t)llround(duration * 1000000.0); // ms to ns
+
+    key->has_scale = obs_data_has_user_value(item, "scale");
+    if (key->has_scale) {
+        key->scale = (float)obs_data_get_double(item, "scale");
+        if (!(key->scale > 0.0f))
+            return false;
+    }
+
+    key->has_center = obs_data_has_user_value(item, "x") && obs_data_has_user_value(item, "y");
+    if (key->has_center) {
+        key->x = (float)obs_data_get_double(item, "x");
+        key->y = (float)obs_data_get_double(item, "y");
+    }
+    return true;
+}
+
+bool script_load_timeline(const char *path, struct timeline_data *timeline)
+{
+    obs_data_t *data = obs_data_create_from_json_file(path);
+    bool ok = false;
+
+    if (!data) {
+        blog(LOG_WARNING, "[zoom-script] failed to read '%s'", path);
+        return false;
+    }
+
+    obs_data_array_t *array = obs_data_get_array(data, "keyframes");
+    size_t count = array ? obs_data_array_count(array) : 0;
+
+    if (count == 0 || count > TIMELINE_MAX_KEYS) {
+        blog(LOG_WARNING, "[zoom-script] '%s': expected 1-%d keyframes, found %zu",
+             path, TIMELINE_MAX_KEYS, count);
+    } else {
+        struct timeline_key *keys = bzalloc(count * sizeof(*keys));
+        size_t i;
+
+        for (i = 0; i < count; i++) {
+            obs_data_t *item = obs_data_array_item(array, i);
+            bool valid = item && read_key(item, &keys[i]);
+            obs_data_release(item);
+
+            if (!valid) {
+                blog(LOG_WARNING, "[zoom-script] '%s': keyframe %zu is invalid", path, i);
+                break;
+            }
+        }
+
+        if (i == count) {
+            ok = timeline_compile(timeline, keys, count);
+            if (ok) {
+                blog(LOG_INFO, "[zoom-script] loaded %zu keyframes from '%s'", count, path);
+            }
+        }
+        bfree(keys);
+    }
+
+    obs_data_array_release(array);
+    obs_data_release(data);
+    return ok;
+}
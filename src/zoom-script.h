@@ -0,0 +1,17 @@
+#ifndef ZOOM_SCRIPT_H
+#define ZOOM_SCRIPT_H
+
+#include <stdbool.h>
+#include "zoom-timeline.h"
+
+// 读取JSON格式的缩放脚本并编译成时间轴，例如：
+// {
+//     "keyframes": [
+//         { "time": "00:12", "scale": 2.5, "x": 0.3, "y": 0.7, "duration": 600 },
+//         { "time": 20, "scale": 1.0, "duration": 400 }
+//     ]
+// }
+// time：秒数或"分:秒"文本；duration：过渡时长(ms)；scale、x/y可省略（保持之前的值）
+bool script_load_timeline(const char *path, struct timeline_data *timeline);
+
+#endif // ZOOM_SCRIPT_H
@@ -1,6 +1,6 @@
 #include "zoom-smoothing.h"
 #include <math.h>
-#include <util/platform.h>
+#include <string.h>
 
 // 初始化平滑数据
 void smoothing_init(struct smoothing_data *smoothing)
@@ -10,13 +10,48 @@ void smoothing_init(struct smoothing_data *smoothing)
     smoothing->mode = SMOOTH_MODE_EXPONENTIAL;
     smoothing->current_scale = 1.0f;
     smoothing->target_scale = 1.0f;
+    smoothing->start_scale = 1.0f;
+    smoothing->velocity = 0.0f;
     smoothing->transition_start = 0;
+    smoothing->last_update = 0;
     smoothing->animation_time = 400 * 1000000; // 400ms默认
+    smoothing->transition_time = 0;
     
     // 初始化新增的平滑控制参数
     smoothing->start_speed = 1.0f;    // 默认值1.0表示正常速度
     smoothing->end_deceleration = 1.0f; // 默认值1.0表示正常减速
     smoothing->overshoot = 0.0f;      // 默认值0.0表示无超调
+    
+    smoothing->rate = 1.0f;
+    smoothing->rate_relative = true;
+    smoothing->rate_ramp = 250 * 1000000; // 250ms
+    smoothing->rate_velocity = 0.0f;
+    smoothing->rate_time = 0;
+    
+    smoothing->curve_valid = false;
+    smoothing_rebuild_curve(smoothing);
+}
+
+// 复制设置和缓动曲线表
+void smoothing_copy_settings(struct smoothing_data *smoothing,
+                             const struct smoothing_data *settings)
+{
+    smoothing->enabled = settings->enabled;
+    smoothing->smoothness = settings->smoothness;
+    smoothing->mode = settings->mode;
+    smoothing->animation_time = settings->animation_time;
+    smoothing->start_speed = settings->start_speed;
+    smoothing->end_deceleration = settings->end_deceleration;
+    smoothing->overshoot = settings->overshoot;
+    smoothing->rate = settings->rate;
+    smoothing->rate_relative = settings->rate_relative;
+    smoothing->rate_ramp = settings->rate_ramp;
+    
+    smoothing->curve = settings->curve;
+    memcpy(smoothing->curve_lut, settings->curve_lut, sizeof(smoothing->curve_lut));
+    smoothing->curve_error = settings->curve_error;
+    memcpy(smoothing->curve_params, settings->curve_params, sizeof(smoothing->curve_params));
+    smoothing->curve_valid = settings->curve_valid;
 }
 
 // 设置新的目标缩放值
@@ -27,61 +62,96 @@ void smoothing_set_target(struct smoothing_data *smoothing,
     // 只有当目标和当前值不同时才触发过渡
     if (fabsf(target_scale - smoothing->target_scale) > 0.001f) {
         smoothing->target_scale = target_scale;
+        smoothing->transition_time = 0;
         
-        if (smoothing->enabled) {
-            // 启用平滑过渡
-            smoothing->transition_start = current_time;
-        } else {
+        if (!smoothing->enabled) {
             // 禁用平滑过渡，立即设置
             smoothing->current_scale = target_scale;
+            smoothing->velocity = 0.0f;
+            smoothing->transition_start = 0;
+        } else if (smoothing->mode == SMOOTH_MODE_SPRING) {
+            // 弹簧模式：只移动目标，当前位置和速度保持不变，
+            // 连续的目标变化因此合并成一段连续运动
+            if (smoothing->transition_start == 0) {
+                smoothing->transition_start = current_time;
+                smoothing->last_update = current_time;
+            }
+        } else {
+            // 曲线模式：从当前位置开始新的一段过渡
+            smoothing->start_scale = smoothing->current_scale;
+            smoothing->transition_start = current_time;
         }
     }
 }
 
-// 根据不同的平滑模式计算当前缩放值
-static float calculate_smoothed_scale(struct smoothing_data *smoothing, 
-                                    float start_scale,
-                                    float end_scale, 
-                                    float t)
+void smoothing_set_target_timed(struct smoothing_data *smoothing,
+                                float target_scale,
+                                uint64_t current_time,
+                                uint64_t duration)
 {
-    if (t >= 1.0f) {
-        return end_scale;
+    if (duration == 0) {
+        smoothing_jump_to(smoothing, target_scale);
+        return;
     }
+    if (fabsf(target_scale - smoothing->target_scale) <= 0.001f)
+        return;
     
-    float diff = end_scale - start_scale;
-    
-    // 防止震荡
-    if (fabsf(diff) < 0.001f) {
-        return end_scale;
+    smoothing->target_scale = target_scale;
+    smoothing->transition_time = duration;
+    if (smoothing->mode == SMOOTH_MODE_SPRING) {
+        if (smoothing->transition_start == 0) {
+            smoothing->transition_start = current_time;
+            smoothing->last_update = current_time;
+        }
+    } else {
+        smoothing->start_scale = smoothing->current_scale;
+        smoothing->transition_start = current_time;
     }
+}
+
+// 本段过渡的时长(ns)
+static uint64_t transition_length(const struct smoothing_data *smoothing)
+{
+    return smoothing->transition_time ? smoothing->transition_time : smoothing->animation_time;
+}
+
+// 起始速度修正 - 调整进度以影响初始速度
+static float adjust_progress(const struct smoothing_data *smoothing, float t)
+{
+    return powf(t, 2.0f / smoothing->start_speed);
+}
+
+// 线性平滑
+static float curve_linear(const struct smoothing_data *smoothing, float t)
+{
+    return adjust_progress(smoothing, t);
+}
+
+// 指数平滑：提供更自然的开始和更平缓的结束
+// 应用结束减速系数来调整曲线陡峭度
+static float curve_exponential(const struct smoothing_data *smoothing, float t)
+{
+    float adjusted_t = adjust_progress(smoothing, t);
+    float sharpness = smoothing->smoothness * smoothing->end_deceleration;
     
-    // 应用起始速度修正值 - 调整进度以影响初始速度
-    float adjusted_t = powf(t, 2.0f / smoothing->start_speed);
-    
-    // 计算基本平滑值
-    float smooth_value = 0.0f;
-    
-    switch (smoothing->mode) {
-        case SMOOTH_MODE_LINEAR:
-            // 线性平滑
-            smooth_value = adjusted_t;
-            break;
-            
-        case SMOOTH_MODE_EXPONENTIAL:
-            // 指数平滑：提供更自然的开始和更平缓的结束
-            // 应用结束减速系数来调整曲线陡峭度
-            smooth_value = 1.0f - expf(-adjusted_t * (2.0f / (smoothing->smoothness * smoothing->end_deceleration)));
-            break;
-            
-        case SMOOTH_MODE_LOGARITHMIC:
-            // 对数平滑：提供更快的开始和更平缓的结束
-            smooth_value = logf(1.0f + adjusted_t * 9.0f) / logf(10.0f);
-            break;
-            
-        default:
-            smooth_value = adjusted_t;
-            break;
+    // 平滑度或结束减速为0时曲线退化为阶跃，限制下限以免 0 * inf 得到NaN
+    if (sharpness < 0.001f) {
+        sharpness = 0.001f;
     }
+    return 1.0f - expf(-adjusted_t * (2.0f / sharpness));
+}
+
+// 对数平滑：提供更快的开始和更平缓的结束
+static float curve_logarithmic(const struct smoothing_data *smoothing, float t)
+{
+    float adjusted_t = adjust_progress(smoothing, t);
+    return logf(1.0f + adjusted_t * 9.0f) / logf(10.0f);
+}
+
+// 按当前模式计算解析曲线值（含超调），仅在建表和校验误差时调用
+static float evaluate_curve(const struct smoothing_data *smoothing, float t)
+{
+    float smooth_value = smoothing->curve(smoothing, t);
     
     // 应用超调/弹性效果 - 使用正弦波在接近目标时产生波动
     if (smoothing->overshoot > 0.0f && t > 0.5f) {
@@ -98,49 +168,246 @@ static float calculate_smoothed_scale(struct smoothing_data *smoothing,
         }
     }
     
+    return smooth_value;
+}
+
+// 查表并线性插值
+static inline float lookup_curve(const struct smoothing_data *smoothing, float t)
+{
+    float pos = t * (float)SMOOTH_LUT_SIZE;
+    int index = (int)pos;
+    
+    if (index >= SMOOTH_LUT_SIZE) {
+        return smoothing->curve_lut[SMOOTH_LUT_SIZE];
+    }
+    if (index < 0) {
+        return smoothing->curve_lut[0];
+    }
+    
+    float frac = pos - (float)index;
+    float a = smoothing->curve_lut[index];
+    return a + (smoothing->curve_lut[index + 1] - a) * frac;
+}
+
+bool smoothing_rebuild_curve(struct smoothing_data *smoothing)
+{
+    const float params[5] = {
+        (float)smoothing->mode,
+        smoothing->smoothness,
+        smoothing->start_speed,
+        smoothing->end_deceleration,
+        smoothing->overshoot,
+    };
+    
+    if (smoothing->curve_valid &&
+        memcmp(params, smoothing->curve_params, sizeof(params)) == 0) {
+        return false;
+    }
+    memcpy(smoothing->curve_params, params, sizeof(params));
+    smoothing->curve_valid = true;
+    
+    // 模式分派只在参数变化时进行一次
+    switch (smoothing->mode) {
+        case SMOOTH_MODE_EXPONENTIAL:
+            smoothing->curve = curve_exponential;
+            break;
+        case SMOOTH_MODE_LOGARITHMIC:
+            smoothing->curve = curve_logarithmic;
+            break;
+        case SMOOTH_MODE_LINEAR:
+        default:
+            smoothing->curve = curve_linear;
+            break;
+    }
+    
+    // 末项取t→1的极限值，t≥1时由调用方直接返回终点
+    for (int i = 0; i <= SMOOTH_LUT_SIZE; i++) {
+        smoothing->curve_lut[i] = evaluate_curve(smoothing, (float)i / (float)SMOOTH_LUT_SIZE);
+    }
+    
+    // 在各区间中点校验插值误差
+    float max_error = 0.0f;
+    for (int i = 0; i < SMOOTH_LUT_SIZE; i++) {
+        float t = ((float)i + 0.5f) / (float)SMOOTH_LUT_SIZE;
+        float error = fabsf(lookup_curve(smoothing, t) - evaluate_curve(smoothing, t));
+        if (error > max_error) {
+            max_error = error;
+        }
+    }
+    smoothing->curve_error = max_error;
+    return true;
+}
+
+// 根据预计算的缓动曲线计算当前缩放值
+static float calculate_smoothed_scale(struct smoothing_data *smoothing, 
+                                    float start_scale,
+                                    float end_scale, 
+                                    float t)
+{
+    if (t >= 1.0f) {
+        return end_scale;
+    }
+    
+    float diff = end_scale - start_scale;
+    
+    // 防止震荡
+    if (fabsf(diff) < 0.001f) {
+        return end_scale;
+    }
+    
     // 应用最终缩放计算
-    return start_scale + diff * smooth_value;
+    return start_scale + diff * lookup_curve(smoothing, t);
+}
+
+// 弹簧收敛判定：剩余距离为动画时长对应的1%时视为到达
+#define SPRING_SETTLE_OMEGA_T 6.64f
+#define SPRING_MAX_DT 0.1f
+#define SPRING_EPSILON_POS 0.0005f
+#define SPRING_EPSILON_VEL 0.005f
+
+// 临界阻尼弹簧：按真实dt精确积分（闭式解，任意步长都稳定）
+static float update_spring(struct smoothing_data *smoothing, uint64_t current_time)
+{
+    float dt = current_time > smoothing->last_update
+        ? (float)(current_time - smoothing->last_update) / 1000000000.0f : 0.0f;
+    smoothing->last_update = current_time;
+    
+    // 长时间未渲染（例如源被隐藏）后不要一步跳过太远
+    if (dt > SPRING_MAX_DT) {
+        dt = SPRING_MAX_DT;
+    }
+    
+    float omega = SPRING_SETTLE_OMEGA_T /
+                  ((float)transition_length(smoothing) / 1000000000.0f);
+    float x = smoothing->current_scale - smoothing->target_scale;
+    float v = smoothing->velocity;
+    float decay = expf(-omega * dt);
+    float tmp = (v + omega * x) * dt;
+    
+    x = (x + tmp) * decay;
+    v = (v - omega * tmp) * decay;
+    
+    if (fabsf(x) < SPRING_EPSILON_POS && fabsf(v) < SPRING_EPSILON_VEL) {
+        // 已收敛：精确停在目标上
+        smoothing->current_scale = smoothing->target_scale;
+        smoothing->velocity = 0.0f;
+        smoothing->transition_start = 0;
+        smoothing->transition_time = 0;
+    } else {
+        smoothing->current_scale = smoothing->target_scale + x;
+        smoothing->velocity = v;
+    }
+    
+    return smoothing->current_scale;
 }
 
 // 更新并获取当前缩放值
 float smoothing_update(struct smoothing_data *smoothing, 
                       uint64_t current_time)
 {
-    if (!smoothing->enabled || smoothing->transition_start == 0 || 
-        smoothing->animation_time == 0) {
-        return smoothing->target_scale;
+    if (smoothing->transition_time == 0 &&
+        (!smoothing->enabled || smoothing->animation_time == 0)) {
+        smoothing->current_scale = smoothing->target_scale;
+        smoothing->velocity = 0.0f;
+        smoothing->transition_start = 0;
+        return smoothing->current_scale;
+    }
+    
+    if (smoothing->transition_start == 0) {
+        return smoothing->current_scale;
+    }
+    
+    if (smoothing->mode == SMOOTH_MODE_SPRING) {
+        return update_spring(smoothing, current_time);
     }
     
     // 计算过渡进度 (0.0 - 1.0)
     float t = (float)(current_time - smoothing->transition_start) / 
-              (float)smoothing->animation_time;
+              (float)transition_length(smoothing);
     
     // 如果超过动画时间，直接设置为目标值
     if (t >= 1.0f) {
         smoothing->current_scale = smoothing->target_scale;
         smoothing->transition_start = 0; // 标记过渡结束
+        smoothing->transition_time = 0;
         return smoothing->current_scale;
     }
     
-    // 应用选定的平滑算法
-    float start_scale = smoothing->current_scale;
+    // 应用选定的平滑算法：曲线始终从本段的起点计算，与帧率无关
     smoothing->current_scale = calculate_smoothed_scale(
-        smoothing, start_scale, smoothing->target_scale, t);
+        smoothing, smoothing->start_scale, smoothing->target_scale, t);
     
     return smoothing->current_scale;
 }
 
+// 立即跳到指定缩放值
+void smoothing_jump_to(struct smoothing_data *smoothing, float scale)
+{
+    smoothing->current_scale = scale;
+    smoothing->target_scale = scale;
+    smoothing->start_scale = scale;
+    smoothing->velocity = 0.0f;
+    smoothing->transition_start = 0;
+    smoothing->transition_time = 0;
+}
+
+bool smoothing_update_rate(struct smoothing_data *smoothing, int direction,
+                           float min_scale, float max_scale, uint64_t current_time)
+{
+    if (direction == 0) {
+        smoothing->rate_velocity = 0.0f;
+        smoothing->rate_time = 0;
+        return false;
+    }
+    if (smoothing->rate_time == 0 || current_time <= smoothing->rate_time) {
+        smoothing->rate_time = current_time;
+        return false;
+    }
+    
+    float dt = (float)(current_time - smoothing->rate_time) / 1000000000.0f;
+    float v0 = smoothing->rate_velocity;
+    float target = direction > 0 ? smoothing->rate : -smoothing->rate;
+    float v1 = target;
+    smoothing->rate_time = current_time;
+    
+    // 速度按固定加速度趋向目标速度，换方向时先减速再反向；没有加速时间时立即达到
+    if (smoothing->rate_ramp > 0) {
+        float step = smoothing->rate * dt * 1000000000.0f / (float)smoothing->rate_ramp;
+        v1 = v0 < target ? fminf(v0 + step, target) : fmaxf(v0 - step, target);
+    } else {
+        v0 = target;
+    }
+    smoothing->rate_velocity = v1;
+    
+    // 梯形积分，加速阶段的位移与帧率无关
+    float distance = 0.5f * (v0 + v1) * dt;
+    float scale = smoothing->rate_relative ? smoothing->current_scale * expf(distance)
+                                           : smoothing->current_scale + distance;
+    scale = fminf(fmaxf(scale, min_scale), max_scale);
+    
+    if (scale == smoothing->current_scale && scale == smoothing->target_scale)
+        return false;
+    smoothing_jump_to(smoothing, scale);
+    return true;
+}
+
 // 检查平滑过渡是否完成
 bool smoothing_is_finished(struct smoothing_data *smoothing, 
                          uint64_t current_time)
 {
-    if (!smoothing->enabled || smoothing->transition_start == 0 || 
-        smoothing->animation_time == 0) {
+    if (smoothing->transition_start == 0 ||
+        (smoothing->transition_time == 0 &&
+         (!smoothing->enabled || smoothing->animation_time == 0))) {
         return true;
     }
     
+    // 弹簧模式没有固定时长，收敛时会清除transition_start
+    if (smoothing->mode == SMOOTH_MODE_SPRING) {
+        return false;
+    }
+    
     float t = (float)(current_time - smoothing->transition_start) / 
-              (float)smoothing->animation_time;
+              (float)transition_length(smoothing);
     
     return (t >= 1.0f);
 }
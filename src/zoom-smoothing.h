@@ -8,6 +8,17 @@
 #define SMOOTH_MODE_LINEAR      0   // 线性
 #define SMOOTH_MODE_EXPONENTIAL 1   // 指数
 #define SMOOTH_MODE_LOGARITHMIC 2   // 对数
+#define SMOOTH_MODE_SPRING      3   // 临界阻尼弹簧（可中途改变目标并保持速度）
+
+// 缓动曲线查找表大小（区间数），表中保存归一化进度t∈[0,1]对应的曲线值
+// 线性插值误差 ≤ h²/8·max|f''|（h = 1/1024）。默认参数下三种模式均 < 1e-6，
+// 全参数范围内最差（指数模式、平滑度与结束减速均为0.1）约为 4.3e-3
+#define SMOOTH_LUT_SIZE 1024
+
+struct smoothing_data;
+
+// 缓动曲线：输入进度t∈[0,1)，返回归一化曲线值
+typedef float (*smoothing_curve_t)(const struct smoothing_data *smoothing, float t);
 
 // 缩放平滑数据结构
 struct smoothing_data {
@@ -16,27 +27,69 @@ struct smoothing_data {
     int mode;               // 平滑模式
     float current_scale;    // 当前缩放值
     float target_scale;     // 目标缩放值
-    uint64_t transition_start; // 过渡开始时间
+    float start_scale;      // 本段过渡的起始缩放值（曲线模式）
+    float velocity;         // 缩放速度（每秒，弹簧模式）
+    uint64_t transition_start; // 过渡开始时间，0表示没有进行中的过渡
+    uint64_t last_update;      // 上次更新时间（弹簧模式按真实dt积分）
     uint64_t animation_time;   // 动画时长(ns)
+    uint64_t transition_time;  // 本段过渡指定的时长(ns)，0表示使用animation_time
     
     // 增强的平滑控制参数
     float start_speed;      // 起始速度系数(0.1-2.0)
     float end_deceleration; // 结束减速系数(0.1-2.0)
     float overshoot;        // 超调系数(0.0-0.5)
+    
+    // 连续缩放（按住热键时按速度直接推进缩放值，不经过过渡动画）
+    float rate;             // 最大速度（每秒）
+    bool rate_relative;     // 速度按当前缩放值的比例计算，1倍和5倍时感觉一致
+    uint64_t rate_ramp;     // 从静止加速到最大速度的时间(ns)，0表示立即达到
+    float rate_velocity;    // 当前速度（每秒，正数放大；按比例时为对数速度）
+    uint64_t rate_time;     // 上次积分的时间，0表示没有进行中的连续缩放
+    
+    // 预计算的缓动曲线（参数变化时由 smoothing_rebuild_curve 重建）
+    smoothing_curve_t curve;            // 当前模式的解析曲线（仅用于建表）
+    float curve_lut[SMOOTH_LUT_SIZE + 1];
+    float curve_error;                  // 查找表相对解析曲线的最大误差
+    float curve_params[5];              // 建表时的参数，未变化时跳过重建
+    bool curve_valid;
 };
 
 // 初始化平滑数据
 void smoothing_init(struct smoothing_data *smoothing);
 
+// 参数（模式、平滑度、起始速度、结束减速、超调）变化后重建缓动曲线查找表
+// 参数未变化时直接返回false，重建后返回true（误差见curve_error）
+bool smoothing_rebuild_curve(struct smoothing_data *smoothing);
+
+// 复制设置和已建好的缓动曲线表（在设置线程准备的参数），不改变进行中的过渡和连续缩放
+void smoothing_copy_settings(struct smoothing_data *smoothing,
+                             const struct smoothing_data *settings);
+
 // 设置新的目标缩放值
 void smoothing_set_target(struct smoothing_data *smoothing, 
                         float target_scale, 
                         uint64_t current_time);
 
+// 用指定时长过渡到新的目标缩放值（程序控制），不受平滑开关和设置中的动画时长影响，
+// duration为0时立即到达
+void smoothing_set_target_timed(struct smoothing_data *smoothing,
+                                float target_scale,
+                                uint64_t current_time,
+                                uint64_t duration);
+
 // 更新并获取当前缩放值
 float smoothing_update(struct smoothing_data *smoothing, 
                       uint64_t current_time);
 
+// 立即跳到指定缩放值，结束进行中的过渡（用于回放录制的轨迹和脚本时间轴）
+void smoothing_jump_to(struct smoothing_data *smoothing, float scale);
+
+// 连续缩放：direction为1（放大）或-1（缩小）时加速，按与上次调用的实际间隔积分缩放值，
+// 结果限制在[min_scale, max_scale]并直接生效（结束进行中的过渡）；为0时停止。
+// 第一次调用只记录时间。返回缩放值是否变化
+bool smoothing_update_rate(struct smoothing_data *smoothing, int direction,
+                           float min_scale, float max_scale, uint64_t current_time);
+
 // 检查平滑过渡是否完成
 bool smoothing_is_finished(struct smoothing_data *smoothing, 
                          uint64_t current_time);
@@ -0,0 +1,146 @@
+#include "zoom-stats.h"
+#include <obs-module.h>
+#include <util/threading.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 最高有效位的位置（value > 0）
+static inline int highest_bit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+// 值所在的桶：小于4的值各占一桶，其余按最高位和其后两位分桶
+static int bucket_index(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return (int)value;
+
+    int msb = highest_bit(value);
+    int sub = (int)((value >> (msb - 2)) & (HISTOGRAM_SUB_BUCKETS - 1));
+    int index = (msb - 1) * HISTOGRAM_SUB_BUCKETS + sub;
+
+    return index < HISTOGRAM_BUCKETS ? index : HISTOGRAM_BUCKETS - 1;
+}
+
+// 桶的上界（含）
+static uint64_t bucket_upper(int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS)
+        return (uint64_t)index;
+
+    int msb = index / HISTOGRAM_SUB_BUCKETS + 1;
+    uint64_t sub = (uint64_t)(index % HISTOGRAM_SUB_BUCKETS);
+    return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << (msb - 2)) - 1;
+}
+
+void histogram_reset(struct zoom_histogram *histogram)
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        os_atomic_set_long(&histogram->buckets[i], 0);
+    os_atomic_set_long(&histogram->count, 0);
+}
+
+void histogram_record(struct zoom_histogram *histogram, uint64_t value)
+{
+    os_atomic_inc_long(&histogram->buckets[bucket_index(value)]);
+    os_atomic_inc_long(&histogram->count);
+}
+
+long histogram_count(const struct zoom_histogram *histogram)
+{
+    return os_atomic_load_long(&histogram->count);
+}
+
+uint64_t histogram_percentile(const struct zoom_histogram *histogram, float percentile)
+{
+    long snapshot[HISTOGRAM_BUCKETS];
+    long total = 0;
+
+    // 读取期间可能仍有写入，以桶的快照为准计算总数
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        snapshot[i] = os_atomic_load_long(&histogram->buckets[i]);
+        total += snapshot[i];
+    }
+    if (total == 0)
+        return 0;
+
+    long rank = (long)((double)percentile * (double)total + 0.5);
+    if (rank < 1)
+        rank = 1;
+    if (rank > total)
+        rank = total;
+
+    long seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += snapshot[i];
+        if (seen >= rank)
+            return bucket_upper(i);
+    }
+    return bucket_upper(HISTOGRAM_BUCKETS - 1);
+}
+
+void stats_init(struct zoom_stats *stats)
+{
+    for (int i = 0; i < STATS_PHASE_COUNT; i++)
+        histogram_reset(&stats->phase[i]);
+    histogram_reset(&stats->frame_cost);
+    histogram_reset(&stats->cursor_age);
+    histogram_reset(&stats->input_latency);
+    
+    os_atomic_set_long(&stats->live.current_scale, 1000);
+    os_atomic_set_long(&stats->live.target_scale, 1000);
+    os_atomic_set_long(&stats->live.center_x, 0);
+    os_atomic_set_long(&stats->live.center_y, 0);
+    os_atomic_set_long(&stats->live.identity_frames, 0);
+    os_atomic_set_long(&stats->live.transform_frames, 0);
+}
+
+// 追加一行百分位摘要（毫秒）
+static size_t format_histogram(char *buf, size_t size, const char *name,
+                               const struct zoom_histogram *histogram)
+{
+    long count = histogram_count(histogram);
+    int written;
+
+    if (count == 0 || size == 0)
+        return 0;
+
+    written = snprintf(buf, size, "%s: n=%ld p50=%.3fms p90=%.3fms p99=%.3fms max=%.3fms\n",
+                       name, count,
+                       (double)histogram_percentile(histogram, 0.50f) / 1000000.0,
+                       (double)histogram_percentile(histogram, 0.90f) / 1000000.0,
+                       (double)histogram_percentile(histogram, 0.99f) / 1000000.0,
+                       (double)histogram_percentile(histogram, 1.00f) / 1000000.0);
+    if (written < 0)
+        return 0;
+    return (size_t)written < size ? (size_t)written : size - 1;
+}
+
+void stats_format(const struct zoom_stats *stats, char *buf, size_t size)
+{
+    static const char *phase_names[STATS_PHASE_COUNT] = {
+        "update", "tracking", "smoothing", "render",
+    };
+    size_t used = 0;
+
+    if (size == 0)
+        return;
+    buf[0] = '\0';
+
+    for (int i = 0; i < STATS_PHASE_COUNT; i++)
+        used += format_histogram(buf + used, size - used, phase_names[i], &stats->phase[i]);
+    used += format_histogram(buf + used, size - used, "frame", &stats->frame_cost);
+    used += format_histogram(buf + used, size - used, "cursor age", &stats->cursor_age);
+    format_histogram(buf + used, size - used, "input latency", &stats->input_latency);
+}
@@ -0,0 +1,63 @@
+#ifndef ZOOM_STATS_H
+#define ZOOM_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 直方图分桶：每个2的幂区间再分4个子桶（相对误差 ≤ 25%），
+// 共36个2的幂区间，覆盖 0 ~ 约137s（单位ns），更大的值计入最后一个桶
+#define HISTOGRAM_SUB_BUCKETS 4
+#define HISTOGRAM_BUCKETS (HISTOGRAM_SUB_BUCKETS * 36)
+
+// 无锁直方图：记录方只做原子自增，读取方可在任意线程随时读取
+struct zoom_histogram {
+    volatile long buckets[HISTOGRAM_BUCKETS];
+    volatile long count;
+};
+
+// 统计的耗时阶段
+#define STATS_PHASE_UPDATE 0        // 命令处理与映射刷新
+#define STATS_PHASE_TRACKING 1      // 光标跟踪
+#define STATS_PHASE_SMOOTHING 2     // 缩放平滑
+#define STATS_PHASE_RENDER 3        // 绘制
+#define STATS_PHASE_COUNT 4
+
+// 诊断面板读取的实时状态：渲染线程无锁写入，界面线程随时读取
+struct zoom_live_stats {
+    volatile long current_scale;    // 当前缩放值（千分之一）
+    volatile long target_scale;     // 目标缩放值（千分之一）
+    volatile long center_x;         // 缩放中心（像素）
+    volatile long center_y;
+    volatile long identity_frames;  // 未缩放、直接跳过滤镜的帧数
+    volatile long transform_frames; // 经过缩放变换的帧数
+};
+
+// 滤镜的延迟统计（单位ns）
+struct zoom_stats {
+    struct zoom_histogram phase[STATS_PHASE_COUNT]; // 各阶段CPU耗时
+    struct zoom_histogram frame_cost;               // 每帧总耗时（模拟 + 首次绘制）
+    struct zoom_histogram cursor_age;               // 绘制时光标采样的年龄（仅光标移动时）
+    struct zoom_histogram input_latency;            // 热键按下到画面开始变化
+    struct zoom_live_stats live;
+};
+
+// 清空直方图
+void histogram_reset(struct zoom_histogram *histogram);
+
+// 记录一个值（无锁，可在任意线程调用）
+void histogram_record(struct zoom_histogram *histogram, uint64_t value);
+
+// 记录数
+long histogram_count(const struct zoom_histogram *histogram);
+
+// 百分位值（percentile为0-1），返回所在桶的上界；没有记录时返回0
+uint64_t histogram_percentile(const struct zoom_histogram *histogram, float percentile);
+
+// 初始化统计数据
+void stats_init(struct zoom_stats *stats);
+
+// 把各项统计的百分位摘要写入buf（每项一行，没有记录的项跳过）
+void stats_format(const struct zoom_stats *stats, char *buf, size_t size);
+
+#endif // ZOOM_STATS_H
@@ -0,0 +1,250 @@
+#include "zoom-timeline.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 排序时带上原始位置，时间相同的关键帧保持脚本中的顺序
+struct sort_entry {
+    struct timeline_key key;
+    size_t order;
+};
+
+static int compare_entries(const void *a, const void *b)
+{
+    const struct sort_entry *ea = a;
+    const struct sort_entry *eb = b;
+
+    if (ea->key.time != eb->key.time)
+        return ea->key.time < eb->key.time ? -1 : 1;
+    return ea->order < eb->order ? -1 : (ea->order > eb->order ? 1 : 0);
+}
+
+static bool sort_keys(struct timeline_key *keys, size_t count)
+{
+    bool sorted = true;
+
+    for (size_t i = 1; i < count && sorted; i++)
+        sorted = keys[i - 1].time <= keys[i].time;
+    if (sorted)
+        return true;
+
+    struct sort_entry *entries = malloc(count * sizeof(*entries));
+    if (!entries)
+        return false;
+    for (size_t i = 0; i < count; i++) {
+        entries[i].key = keys[i];
+        entries[i].order = i;
+    }
+    qsort(entries, count, sizeof(*entries), compare_entries);
+    for (size_t i = 0; i < count; i++)
+        keys[i] = entries[i].key;
+    free(entries);
+    return true;
+}
+
+static float clamp01(float v)
+{
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+bool timeline_parse_time(const char *text, uint64_t *time)
+{
+    double parts[3];
+    int count = 0;
+    const char *p = text;
+
+    if (!text || !*text)
+        return false;
+
+    // 最多三段，只有最后一段可以带小数
+    for (;;) {
+        char *end;
+        double value = strtod(p, &end);
+
+        if (end == p || value < 0.0 || !isfinite(value) || count == 3)
+            return false;
+        parts[count++] = value;
+
+        if (*end == ':') {
+            if (value != floor(value))
+                return false;
+            p = end + 1;
+        } else if (*end == '\0') {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    // 非首段的分、秒必须小于60
+    double seconds = 0.0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && parts[i] >= 60.0)
+            return false;
+        seconds = seconds * 60.0 + parts[i];
+    }
+
+    *time = (uint64_t)llround(seconds * 1000000000.0);
+    return true;
+}
+
+// 相邻两段在衔接处的斜率（每ns），保证单调：方向相反或有一段不变时为0，
+// 否则取按时长加权的平均斜率，并限制在两段平均斜率较小者的3倍以内
+static double junction_slope(const struct timeline_segment *a, const float *a_start,
+                             const struct timeline_segment *b, int c)
+{
+    double len_a = (double)(a->end - a->start);
+    double len_b = (double)(b->end - b->start);
+    double d0 = ((double)a->target[c] - (double)a_start[c]) / len_a;
+    double d1 = ((double)b->target[c] - (double)a->target[c]) / len_b;
+
+    if (d0 * d1 <= 0.0)
+        return 0.0;
+
+    double m = ((double)b->target[c] - (double)a_start[c]) / (len_a + len_b);
+    double limit = 3.0 * fmin(fabs(d0), fabs(d1));
+    return fabs(m) > limit ? copysign(limit, m) : m;
+}
+
+static bool contiguous(const struct timeline_segment *a, const struct timeline_segment *b)
+{
+    return a->end == b->start && a->end > a->start && b->end > b->start;
+}
+
+bool timeline_compile(struct timeline_data *timeline, struct timeline_key *keys, size_t count)
+{
+    memset(timeline, 0, sizeof(*timeline));
+
+    if (!keys || count == 0 || count > TIMELINE_MAX_KEYS || !sort_keys(keys, count))
+        return false;
+
+    struct timeline_segment *segments = calloc(count, sizeof(*segments));
+    float *starts = malloc(count * TIMELINE_COMPONENTS * sizeof(float));
+    if (!segments || !starts) {
+        free(segments);
+        free(starts);
+        return false;
+    }
+
+    // 第一遍：每段的时间范围、起点和终点
+    float state[TIMELINE_COMPONENTS] = {1.0f, 0.5f, 0.5f};
+    for (size_t i = 0; i < count; i++) {
+        const struct timeline_key *key = &keys[i];
+        struct timeline_segment *segment = &segments[i];
+
+        segment->start = key->time;
+        segment->end = key->time + key->duration;
+        if (i + 1 < count && segment->end > keys[i + 1].time)
+            segment->end = keys[i + 1].time;
+
+        memcpy(&starts[i * TIMELINE_COMPONENTS], state, sizeof(state));
+        if (key->has_scale)
+            state[TIMELINE_SCALE] = key->scale;
+        if (key->has_center) {
+            state[TIMELINE_X] = clamp01(key->x);
+            state[TIMELINE_Y] = clamp01(key->y);
+            timeline->has_center = true;
+        }
+        memcpy(segment->target, state, sizeof(state));
+    }
+
+    // 第二遍：衔接处的斜率和三次Hermite系数
+    for (size_t i = 0; i < count; i++) {
+        struct timeline_segment *segment = &segments[i];
+        const float *p0 = &starts[i * TIMELINE_COMPONENTS];
+        double len = (double)(segment->end - segment->start);
+
+        for (int c = 0; c < TIMELINE_COMPONENTS; c++) {
+            double m0 = 0.0, m1 = 0.0;
+
+            if (i > 0 && contiguous(&segments[i - 1], segment))
+                m0 = junction_slope(&segments[i - 1], &starts[(i - 1) * TIMELINE_COMPONENTS],
+                                    segment, c);
+            if (i + 1 < count && contiguous(segment, &segments[i + 1]))
+                m1 = junction_slope(segment, p0, &segments[i + 1], c);
+
+            // 换算成以u为参数的切线
+            double a = p0[c];
+            double b = m0 * len;
+            double delta = (double)segment->target[c] - a;
+            double m1u = m1 * len;
+
+            segment->coef[c][0] = (float)a;
+            segment->coef[c][1] = (float)b;
+            segment->coef[c][2] = (float)(3.0 * delta - 2.0 * b - m1u);
+            segment->coef[c][3] = (float)(-2.0 * delta + b + m1u);
+        }
+    }
+
+    free(starts);
+    timeline->segments = segments;
+    timeline->count = count;
+    return true;
+}
+
+void timeline_free(struct timeline_data *timeline)
+{
+    free(timeline->segments);
+    memset(timeline, 0, sizeof(*timeline));
+}
+
+// 最后一个start不晚于t的段（调用方保证第一段满足）
+static size_t find_segment(const struct timeline_data *timeline, uint64_t t)
+{
+    size_t lo = 0;
+    size_t hi = timeline->count;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (timeline->segments[mid].start <= t)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void timeline_evaluate(struct timeline_data *timeline, uint64_t t,
+                       float *scale, float *x, float *y)
+{
+    float value[TIMELINE_COMPONENTS] = {1.0f, 0.5f, 0.5f};
+
+    if (timeline->count && t >= timeline->segments[0].start) {
+        // 从上一次的位置向前查找，倒退或跨越太多段时二分查找
+        size_t i = timeline->cursor;
+        if (timeline->segments[i].start > t) {
+            i = find_segment(timeline, t);
+        } else {
+            int steps = 0;
+            while (i + 1 < timeline->count && timeline->segments[i + 1].start <= t) {
+                if (++steps > TIMELINE_SCAN_SEGMENTS) {
+                    i = find_segment(timeline, t);
+                    break;
+                }
+                i++;
+            }
+        }
+        timeline->cursor = i;
+
+        const struct timeline_segment *segment = &timeline->segments[i];
+        if (t >= segment->end) {
+            memcpy(value, segment->target, sizeof(value));
+        } else {
+            float u = (float)((double)(t - segment->start) /
+                              (double)(segment->end - segment->start));
+            for (int c = 0; c < TIMELINE_COMPONENTS; c++) {
+                const float *k = segment->coef[c];
+                value[c] = k[0] + u * (k[1] + u * (k[2] + u * k[3]));
+            }
+        }
+    }
+
+    *scale = value[TIMELINE_SCALE];
+    *x = value[TIMELINE_X];
+    *y = value[TIMELINE_Y];
+}
+
+bool timeline_finished(const struct timeline_data *timeline, uint64_t t)
+{
+    return timeline->count == 0 || t >= timeline->segments[timeline->count - 1].end;
+}
@@ -0,0 +1,63 @@
+#ifndef ZOOM_TIMELINE_H
+#define ZOOM_TIMELINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 时间轴的分量
+#define TIMELINE_SCALE 0
+#define TIMELINE_X 1
+#define TIMELINE_Y 2
+#define TIMELINE_COMPONENTS 3
+
+// 时间轴关键帧上限
+#define TIMELINE_MAX_KEYS 100000
+
+// 顺序播放时最多逐段前移这么多段，超过后改用二分查找
+#define TIMELINE_SCAN_SEGMENTS 8
+
+// 脚本中的一个关键帧：从time开始，用duration把缩放/中心过渡到指定值
+struct timeline_key {
+    uint64_t time;          // 相对时间轴开始的时间(ns)
+    uint64_t duration;      // 过渡时长(ns)
+    float scale;
+    float x;                // 缩放中心（源内相对坐标，0-1）
+    float y;
+    bool has_scale;         // 未指定的分量保持上一个关键帧的值
+    bool has_center;
+};
+
+// 编译后的一段过渡：每个分量是以u=(t-start)/(end-start)为参数的三次多项式
+struct timeline_segment {
+    uint64_t start;
+    uint64_t end;
+    float coef[TIMELINE_COMPONENTS][4];   // a + b*u + c*u^2 + d*u^3
+    float target[TIMELINE_COMPONENTS];    // 本段结束后保持的值
+};
+
+struct timeline_data {
+    struct timeline_segment *segments;    // 按开始时间排序
+    size_t count;
+    size_t cursor;          // 上一次查找到的段
+    bool has_center;        // 脚本是否控制缩放中心（否则中心仍由鼠标跟踪决定）
+};
+
+// 解析时间文本：秒、"分:秒"或"时:分:秒"，秒可带小数（如 "01:02.5"）
+bool timeline_parse_time(const char *text, uint64_t *time);
+
+// 把关键帧编译成按时间排序的样条段（会对keys排序，时间相同的按原顺序）
+// 重叠的过渡提前在下一个关键帧开始时完成；相邻的过渡在衔接处保持速度连续且不越过目标
+bool timeline_compile(struct timeline_data *timeline, struct timeline_key *keys, size_t count);
+
+// 释放编译结果
+void timeline_free(struct timeline_data *timeline);
+
+// 求值（t为相对时间轴开始的时间），顺序播放时每帧常数时间
+void timeline_evaluate(struct timeline_data *timeline, uint64_t t,
+                       float *scale, float *x, float *y);
+
+// 最后一段过渡是否已经结束
+bool timeline_finished(const struct timeline_data *timeline, uint64_t t);
+
+#endif // ZOOM_TIMELINE_H
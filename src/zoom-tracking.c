@@ -1,74 +1,435 @@
 #include "zoom-tracking.h"
 #include <math.h>
-#include <util/platform.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#elif defined(__APPLE__)
-#include <ApplicationServices/ApplicationServices.h>
-#else
-#include <X11/Xlib.h>
-#include <X11/extensions/Xfixes.h>
-#endif
-
-// 获取鼠标位置的平台相关实现
-static void get_mouse_pos(struct vec2 *pos)
-{
-#ifdef _WIN32
-    POINT mouse_pos;
-    GetCursorPos(&mouse_pos);
-    pos->x = (float)mouse_pos.x;
-    pos->y = (float)mouse_pos.y;
-#elif defined(__APPLE__)
-    CGEventRef event = CGEventCreate(NULL);
-    CGPoint mouse_pos = CGEventGetLocation(event);
-    CFRelease(event);
-    pos->x = (float)mouse_pos.x;
-    pos->y = (float)mouse_pos.y;
-#else
-    Display *display = XOpenDisplay(NULL);
-    if (display) {
-        Window root, child;
-        int root_x, root_y, win_x, win_y;
-        unsigned int mask;
-        XQueryPointer(display, DefaultRootWindow(display),
-            &root, &child, &root_x, &root_y, &win_x, &win_y, &mask);
-        XCloseDisplay(display);
-        pos->x = (float)root_x;
-        pos->y = (float)root_y;
+
+// 光标位置（桌面坐标，像素）
+struct tracking_point {
+    float x;
+    float y;
+};
+
+// 获取插值到当前帧时间的鼠标位置
+// per_frame为true时使用所有实例共享的每帧缓存，延迟锁存则需要最新位置
+static bool get_mouse_pos(const struct tracking_data *tracking, struct tracking_point *pos,
+                          uint64_t timestamp, bool per_frame)
+{
+    const struct tracking_cursor *cursor = tracking->cursor;
+
+    if (!cursor)
+        return false;
+
+    return per_frame ? cursor->get_frame(timestamp, &pos->x, &pos->y)
+                     : cursor->get(timestamp, &pos->x, &pos->y);
+}
+
+// 估计光标速度（像素/秒）
+static bool get_mouse_velocity(const struct tracking_data *tracking, uint64_t timestamp,
+                               uint64_t window_ns, float *vx, float *vy)
+{
+    const struct tracking_cursor *cursor = tracking->cursor;
+
+    return cursor && cursor->get_velocity(timestamp, window_ns, vx, vy);
+}
+
+// 速度估计窗口：恒速模型取最近这段时间的平均速度
+#define VELOCITY_WINDOW_NS 20000000ULL    // 20ms
+
+// 卡尔曼滤波噪声参数（像素单位）
+#define KALMAN_ACCEL_NOISE 20000.0f       // 加速度过程噪声方差 (px/s^2)^2 的尺度
+#define KALMAN_MEASURE_NOISE 1.0f         // 测量噪声方差 (px^2)
+
+// 误差滑动平均系数
+#define PREDICT_ERROR_ALPHA 0.05f
+
+// 释放程序指定的中心后，离画面中心小于此距离（像素）时视为已回到中心
+#define RETURN_SNAP_PX 0.01f
+
+// 平滑系数：本帧向目标移动的比例。按指数衰减计算（rate = 1/时间常数），
+// 任意帧率下经过相同时间剩余的距离都相同
+static float calculate_smooth_factor(float rate, float dt)
+{
+    return 1.0f - expf(-rate * dt);
+}
+
+// 死区：目标在以当前中心为中心的矩形内时不移动，越出时只移动到让目标落在矩形边上
+static float dead_zone_goal(float center, float target, float half_extent)
+{
+    float offset = target - center;
+
+    if (offset > half_extent)
+        return target - half_extent;
+    if (offset < -half_extent)
+        return target + half_extent;
+    return center;
+}
+
+static float clamp01(float v)
+{
+    return (v < 0.0f) ? 0.0f : (v > 1.0f) ? 1.0f : v;
+}
+
+// 向目标平滑移动，返回本帧的跟随比例（停稳时为0）
+// 剩余距离在稳定阈值内时对齐到目标，之后保持位置完全不变，直到目标再次越过阈值。
+// 程序指定的位置不使用死区，总是移动到目标本身
+static float follow_target(struct tracking_data *tracking, float target_x, float target_y,
+                           float width, float height, float scale, float dt, bool dead_zone)
+{
+    // 死区按可见区域的比例计算，放大后死区在源内相应缩小
+    float visible = !dead_zone ? 0.0f : scale > 1.0f ? 1.0f / scale : 1.0f;
+    float goal_x = dead_zone_goal(tracking->mouse_x, target_x,
+                                  tracking->dead_zone_x * 0.5f * visible);
+    float goal_y = dead_zone_goal(tracking->mouse_y, target_y,
+                                  tracking->dead_zone_y * 0.5f * visible);
+    float dx = goal_x - tracking->mouse_x;
+    float dy = goal_y - tracking->mouse_y;
+
+    if (fabsf(dx) * width <= tracking->settle_threshold &&
+        fabsf(dy) * height <= tracking->settle_threshold) {
+        if (!tracking->settled) {
+            tracking->mouse_x = goal_x;
+            tracking->mouse_y = goal_y;
+            tracking->settled = true;
+        }
+        return 0.0f;
+    }
+    tracking->settled = false;
+
+    float follow = 1.0f;
+    if (tracking->smooth_enabled)
+        follow = calculate_smooth_factor(tracking->smoothness * 10.0f, dt);
+
+    tracking->mouse_x += dx * follow;
+    tracking->mouse_y += dy * follow;
+    return follow;
+}
+
+// 桌面坐标转换为源内相对坐标（0-1范围），映射未解析时按源尺寸相除
+static void to_relative(const struct tracking_data *tracking, const struct tracking_point *pos,
+                        float width, float height, float *rel_x, float *rel_y)
+{
+    if (tracking->mapping.valid) {
+        mapping_apply(&tracking->mapping, pos->x, pos->y, rel_x, rel_y);
     } else {
-        pos->x = 0;
-        pos->y = 0;
+        *rel_x = pos->x / width;
+        *rel_y = pos->y / height;
     }
-#endif
+
+    *rel_x = clamp01(*rel_x);
+    *rel_y = clamp01(*rel_y);
+}
+
+// 卡尔曼滤波：以恒速模型预测dt后的状态，再用测量值z修正
+static void kalman_step(struct tracking_kalman *kf, float z, float dt)
+{
+    if (!kf->valid || dt <= 0.0f || dt > 0.5f) {
+        // 首次测量或长时间未更新：重置状态，速度未知
+        kf->pos = z;
+        kf->vel = 0.0f;
+        kf->p00 = KALMAN_MEASURE_NOISE;
+        kf->p01 = 0.0f;
+        kf->p11 = 1000000.0f;
+        kf->valid = true;
+        return;
+    }
+
+    // 预测
+    float dt2 = dt * dt;
+    float q = KALMAN_ACCEL_NOISE;
+    kf->pos += kf->vel * dt;
+    kf->p00 += dt * (2.0f * kf->p01 + dt * kf->p11) + q * dt2 * dt2 * 0.25f;
+    kf->p01 += dt * kf->p11 + q * dt2 * dt * 0.5f;
+    kf->p11 += q * dt2;
+
+    // 修正
+    float s = kf->p00 + KALMAN_MEASURE_NOISE;
+    float k0 = kf->p00 / s;
+    float k1 = kf->p01 / s;
+    float residual = z - kf->pos;
+    kf->pos += k0 * residual;
+    kf->vel += k1 * residual;
+    kf->p11 -= k1 * kf->p01;
+    kf->p01 -= k0 * kf->p01;
+    kf->p00 -= k0 * kf->p00;
+}
+
+// 把光标位置外推到预测时长之后，失败时保持原位置
+static void predict_position(struct tracking_data *tracking, struct tracking_point *pos,
+                             uint64_t current_time, float dt)
+{
+    float horizon = (float)tracking->predict_horizon / 1000000000.0f;
+    float vx, vy;
+
+    switch (tracking->predict_mode) {
+        case PREDICT_MODE_VELOCITY:
+            if (!get_mouse_velocity(tracking, current_time, VELOCITY_WINDOW_NS, &vx, &vy))
+                return;
+            break;
+        case PREDICT_MODE_KALMAN:
+            kalman_step(&tracking->kf_x, pos->x, dt);
+            kalman_step(&tracking->kf_y, pos->y, dt);
+            pos->x = tracking->kf_x.pos;
+            pos->y = tracking->kf_y.pos;
+            vx = tracking->kf_x.vel;
+            vy = tracking->kf_y.vel;
+            break;
+        case PREDICT_MODE_NONE:
+        default:
+            return;
+    }
+
+    pos->x += vx * horizon;
+    pos->y += vy * horizon;
+}
+
+// 记录一次预测，等到达目标时间后校验
+static void push_prediction(struct tracking_data *tracking, const struct tracking_point *pos,
+                            uint64_t target_time)
+{
+    if (tracking->pending_count == PREDICT_PENDING_MAX) {
+        // 队列已满：丢弃最旧的一条
+        tracking->pending_head = (tracking->pending_head + 1) % PREDICT_PENDING_MAX;
+        tracking->pending_count--;
+    }
+
+    int index = (tracking->pending_head + tracking->pending_count) % PREDICT_PENDING_MAX;
+    tracking->pending[index].target_time = target_time;
+    tracking->pending[index].x = pos->x;
+    tracking->pending[index].y = pos->y;
+    tracking->pending_count++;
+}
+
+// 校验已到期的预测：与采样线程记录的实际位置比较
+static void check_predictions(struct tracking_data *tracking, uint64_t current_time)
+{
+    while (tracking->pending_count > 0) {
+        struct tracking_prediction *p = &tracking->pending[tracking->pending_head];
+        struct tracking_point actual;
+
+        if (p->target_time > current_time)
+            break;
+
+        if (get_mouse_pos(tracking, &actual, p->target_time, false)) {
+            float error = hypotf(actual.x - p->x, actual.y - p->y);
+
+            if (tracking->predict_checked == 0)
+                tracking->predict_error = error;
+            else
+                tracking->predict_error += (error - tracking->predict_error) * PREDICT_ERROR_ALPHA;
+            if (error > tracking->predict_error_max)
+                tracking->predict_error_max = error;
+            tracking->predict_checked++;
+        }
+
+        tracking->pending_head = (tracking->pending_head + 1) % PREDICT_PENDING_MAX;
+        tracking->pending_count--;
+    }
+}
+
+// 重置预测状态和误差统计
+static void reset_prediction(struct tracking_data *tracking)
+{
+    tracking->kf_x.valid = false;
+    tracking->kf_y.valid = false;
+    tracking->pending_head = 0;
+    tracking->pending_count = 0;
+    tracking->predict_error = 0.0f;
+    tracking->predict_error_max = 0.0f;
+    tracking->predict_checked = 0;
 }
 
-// 平滑值计算
-static float calculate_smooth_value(float current, float target, float smoothness, float dt)
+void mapping_init(struct tracking_mapping *mapping)
 {
-    float t = smoothness * dt;
-    // 限制最大变化率以防止过度震荡
-    t = t > 1.0f ? 1.0f : t;
-    return current + (target - current) * t;
+    mapping->scale_x = 1.0f;
+    mapping->scale_y = 1.0f;
+    mapping->offset_x = 0.0f;
+    mapping->offset_y = 0.0f;
+    mapping->generation = -1;
+    mapping->width = 0;
+    mapping->height = 0;
+    mapping->valid = false;
+}
+
+void mapping_invalidate(struct tracking_mapping *mapping)
+{
+    mapping->valid = false;
+}
+
+void mapping_set_region(struct tracking_mapping *mapping,
+                        float x, float y, float width, float height,
+                        long generation, uint32_t source_width, uint32_t source_height)
+{
+    mapping->scale_x = width > 0.0f ? 1.0f / width : 0.0f;
+    mapping->scale_y = height > 0.0f ? 1.0f / height : 0.0f;
+    mapping->offset_x = -x * mapping->scale_x;
+    mapping->offset_y = -y * mapping->scale_y;
+    mapping->generation = generation;
+    mapping->width = source_width;
+    mapping->height = source_height;
+    mapping->valid = true;
 }
 
 // 初始化跟踪数据
-void tracking_init(struct tracking_data *tracking)
+void tracking_init(struct tracking_data *tracking, const struct tracking_cursor *cursor)
 {
     tracking->mode = TRACKING_MODE_DISABLED;
     tracking->mouse_x = 0.5f;
     tracking->mouse_y = 0.5f;
     tracking->smooth_enabled = true;
     tracking->smoothness = 0.6f;
-    tracking->last_update = os_gettime_ns();
+    tracking->dead_zone_x = 0.0f;
+    tracking->dead_zone_y = 0.0f;
+    tracking->settle_threshold = 0.0f;
+    tracking->settled = false;
+    tracking->last_update = 0;    // 首次更新前没有有效的时间差
+    tracking->cursor = cursor;
+    tracking->cursor_acquired = false;
+    mapping_init(&tracking->mapping);
+    tracking->focus_x = 0.5f;
+    tracking->focus_y = 0.5f;
+    tracking->focus_valid = false;
+    tracking->pan_active = false;
+    tracking->pan_returning = false;
+
+    tracking->predict_mode = PREDICT_MODE_NONE;
+    tracking->predict_horizon = 0;
+    reset_prediction(tracking);
+
+    tracking->latch_active = false;
+    tracking->latch_follow = 1.0f;
+    tracking->target_x = 0.5f;
+    tracking->target_y = 0.5f;
+}
+
+// 释放跟踪数据
+void tracking_free(struct tracking_data *tracking)
+{
+    if (tracking->cursor_acquired) {
+        tracking->cursor->release();
+        tracking->cursor_acquired = false;
+    }
+}
+
+// 设置跟踪模式，跟随光标时才获取光标数据源
+void tracking_set_mode(struct tracking_data *tracking, int mode)
+{
+    bool uses_cursor = mode == TRACKING_MODE_REALTIME || mode == TRACKING_MODE_ZOOMING;
+
+    // 回到中心只对无跟踪模式有意义，切换模式后不再继续
+    if (mode != tracking->mode)
+        tracking->pan_returning = false;
+    tracking->mode = mode;
+
+    if (!tracking->cursor)
+        return;
+
+    if (uses_cursor && !tracking->cursor_acquired) {
+        // 后端不可用时不持有引用，下次设置模式时重试
+        tracking->cursor_acquired = tracking->cursor->acquire();
+    } else if (!uses_cursor && tracking->cursor_acquired) {
+        tracking->cursor->release();
+        tracking->cursor_acquired = false;
+    }
+}
+
+// 设置自动取景的焦点
+void tracking_set_focus(struct tracking_data *tracking, float x, float y)
+{
+    tracking->focus_x = clamp01(x);
+    tracking->focus_y = clamp01(y);
+    tracking->focus_valid = true;
+}
+
+// 直接设置跟踪位置，本帧不再做延迟锁存
+void tracking_pan_to(struct tracking_data *tracking, float x, float y)
+{
+    bool active = x >= 0.0f && y >= 0.0f;
+
+    // 无跟踪模式下画面一直在中心，从中心开始移动（正在回到中心时从当前位置开始）
+    if (active && !tracking->pan_active && !tracking->pan_returning &&
+        tracking->mode == TRACKING_MODE_DISABLED) {
+        tracking->mouse_x = 0.5f;
+        tracking->mouse_y = 0.5f;
+        tracking->settled = false;
+    }
+
+    // 无跟踪模式下释放后不直接跳回中心，由更新按平移的平滑方式移回去
+    if (!active && tracking->pan_active && tracking->mode == TRACKING_MODE_DISABLED) {
+        tracking->pan_returning = true;
+        tracking->settled = false;
+    }
+    if (active)
+        tracking->pan_returning = false;
+
+    tracking->pan_active = active;
+    if (active) {
+        tracking->pan_x = clamp01(x);
+        tracking->pan_y = clamp01(y);
+    }
+}
+
+void tracking_set_position(struct tracking_data *tracking, float x, float y)
+{
+    tracking->mouse_x = clamp01(x);
+    tracking->mouse_y = clamp01(y);
+    tracking->latch_active = false;
+}
+
+// 设置预测模型和预测时长
+void tracking_set_prediction(struct tracking_data *tracking, int mode, int horizon_ms)
+{
+    uint64_t horizon = horizon_ms > 0 ? (uint64_t)horizon_ms * 1000000 : 0;
+
+    if (mode != tracking->predict_mode || horizon != tracking->predict_horizon)
+        reset_prediction(tracking);
+
+    tracking->predict_mode = mode;
+    tracking->predict_horizon = horizon;
 }
 
 // 更新鼠标位置
-void tracking_update_mouse(struct tracking_data *tracking, 
-                         float width, float height, 
+void tracking_update_mouse(struct tracking_data *tracking,
+                         float width, float height,
                          float scale, float last_scale,
                          uint64_t current_time)
 {
+    tracking->latch_active = false;
+
+    // 计算时间差（首次更新时为0）
+    float dt = tracking->last_update && current_time > tracking->last_update
+             ? (float)(current_time - tracking->last_update) / 1000000000.0f // ns to s
+             : 0.0f;
+
+    // 程序指定的中心：平滑方式与光标跟踪相同，不读取光标（回放和脚本由调用方设置位置）
+    if (tracking->pan_active && tracking->mode != TRACKING_MODE_EXTERNAL) {
+        follow_target(tracking, tracking->pan_x, tracking->pan_y, width, height, scale, dt,
+                      false);
+        tracking->last_update = current_time;
+        return;
+    }
+
+    // 无跟踪模式下释放程序指定的中心后回到画面中心，到达后恢复固定的中心
+    if (tracking->pan_returning && tracking->mode == TRACKING_MODE_DISABLED) {
+        follow_target(tracking, 0.5f, 0.5f, width, height, scale, dt, false);
+        if (tracking->settled ||
+            (fabsf(tracking->mouse_x - 0.5f) * width < RETURN_SNAP_PX &&
+             fabsf(tracking->mouse_y - 0.5f) * height < RETURN_SNAP_PX)) {
+            tracking->mouse_x = 0.5f;
+            tracking->mouse_y = 0.5f;
+            tracking->pan_returning = false;
+        }
+        tracking->last_update = current_time;
+        return;
+    }
+
+    // 自动取景：跟随画面活动焦点，平滑方式与光标跟踪相同，不读取光标
+    if (tracking->mode == TRACKING_MODE_ACTIVITY) {
+        if (tracking->focus_valid) {
+            follow_target(tracking, tracking->focus_x, tracking->focus_y,
+                          width, height, scale, dt, true);
+        }
+        tracking->last_update = current_time;
+        return;
+    }
+
     // 根据跟踪模式确定是否更新鼠标位置
     bool should_update = false;
     
@@ -90,43 +451,50 @@ void tracking_update_mouse(struct tracking_data *tracking,
     
     if (should_update) {
         // 获取鼠标位置
-        struct vec2 mouse_pos;
-        get_mouse_pos(&mouse_pos);
-        
-        // 计算相对位置（0-1范围）
-        float target_x = mouse_pos.x / width;
-        float target_y = mouse_pos.y / height;
-        
-        // 限制在0-1范围内
-        target_x = (target_x < 0.0f) ? 0.0f : (target_x > 1.0f) ? 1.0f : target_x;
-        target_y = (target_y < 0.0f) ? 0.0f : (target_y > 1.0f) ? 1.0f : target_y;
-        
-        // 计算时间差
-        float dt = (float)(current_time - tracking->last_update) / 1000000000.0f; // ns to s
-        
-        // 应用平滑过渡
-        if (tracking->smooth_enabled) {
-            tracking->mouse_x = calculate_smooth_value(tracking->mouse_x, target_x, tracking->smoothness * 10.0f, dt);
-            tracking->mouse_y = calculate_smooth_value(tracking->mouse_y, target_y, tracking->smoothness * 10.0f, dt);
-        } else {
-            tracking->mouse_x = target_x;
-            tracking->mouse_y = target_y;
+        struct tracking_point mouse_pos;
+        if (!get_mouse_pos(tracking, &mouse_pos, current_time, true)) {
+            tracking->last_update = current_time;
+            return;
+        }
+
+        // 外推到预测的显示时间，并记录下来以便之后统计误差
+        if (tracking->predict_mode != PREDICT_MODE_NONE) {
+            check_predictions(tracking, current_time);
+            predict_position(tracking, &mouse_pos, current_time, dt);
+            push_prediction(tracking, &mouse_pos, current_time + tracking->predict_horizon);
         }
+
+        // 计算相对位置（0-1范围），并限制在0-1范围内
+        float target_x, target_y;
+        to_relative(tracking, &mouse_pos, width, height, &target_x, &target_y);
+
+        // 应用死区和平滑过渡
+        float follow = follow_target(tracking, target_x, target_y, width, height, scale, dt,
+                                     true);
+
+        // 记录本帧目标，供渲染前的延迟锁存使用；停稳后不锁存，绘制的中心逐帧完全相同
+        tracking->latch_active = follow > 0.0f;
+        tracking->latch_follow = follow;
+        tracking->target_x = target_x;
+        tracking->target_y = target_y;
     }
     
     tracking->last_update = current_time;
 }
 
 // 获取跟踪位置（单位：像素）
-void tracking_get_center(struct tracking_data *tracking,
+void tracking_get_center(const struct tracking_data *tracking,
                         float width, float height,
                         float *center_x, float *center_y)
 {
+    bool moving;
+
     switch (tracking->mode) {
         case TRACKING_MODE_DISABLED:
-            // 无跟踪模式：使用中心点
-            *center_x = width * 0.5f;
-            *center_y = height * 0.5f;
+            // 无跟踪模式：使用中心点（程序指定中心以及释放后回到中心的过程除外）
+            moving = tracking->pan_active || tracking->pan_returning;
+            *center_x = width * (moving ? tracking->mouse_x : 0.5f);
+            *center_y = height * (moving ? tracking->mouse_y : 0.5f);
             break;
         case TRACKING_MODE_REALTIME:
         case TRACKING_MODE_ZOOMING:
@@ -137,3 +505,47 @@ void tracking_get_center(struct tracking_data *tracking,
             break;
     }
 }
+
+// 延迟锁存：渲染前以最新时间重新读取光标，把与本帧目标的差值按平滑比例叠加到中心点上
+// 只影响本次绘制，不修改跟踪状态
+void tracking_get_latched_center(const struct tracking_data *tracking,
+                                float width, float height,
+                                uint64_t current_time,
+                                float *center_x, float *center_y)
+{
+    struct tracking_point pos;
+    float vx, vy;
+
+    tracking_get_center(tracking, width, height, center_x, center_y);
+
+    if (!tracking->latch_active || !get_mouse_pos(tracking, &pos, current_time, false))
+        return;
+
+    // 使用更新时得到的速度继续外推，不推进滤波器状态
+    float horizon = (float)tracking->predict_horizon / 1000000000.0f;
+    if (tracking->predict_mode == PREDICT_MODE_KALMAN && tracking->kf_x.valid) {
+        pos.x += tracking->kf_x.vel * horizon;
+        pos.y += tracking->kf_y.vel * horizon;
+    } else if (tracking->predict_mode == PREDICT_MODE_VELOCITY &&
+               get_mouse_velocity(tracking, current_time, VELOCITY_WINDOW_NS, &vx, &vy)) {
+        pos.x += vx * horizon;
+        pos.y += vy * horizon;
+    }
+
+    float rel_x, rel_y;
+    to_relative(tracking, &pos, width, height, &rel_x, &rel_y);
+    *center_x = width * clamp01(tracking->mouse_x + (rel_x - tracking->target_x) * tracking->latch_follow);
+    *center_y = height * clamp01(tracking->mouse_y + (rel_y - tracking->target_y) * tracking->latch_follow);
+}
+
+// 获取预测误差统计
+bool tracking_get_prediction_error(const struct tracking_data *tracking,
+                                  float *mean, float *max)
+{
+    if (tracking->predict_checked == 0)
+        return false;
+
+    *mean = tracking->predict_error;
+    *max = tracking->predict_error_max;
+    return true;
+}
@@ -2,12 +2,63 @@
 #define ZOOM_TRACKING_H
 
 #include <stdbool.h>
-#include <obs-module.h>
+#include <stdint.h>
+#include <math.h>
 
 // 跟踪模式
 #define TRACKING_MODE_DISABLED 0    // 无跟踪
 #define TRACKING_MODE_REALTIME 1    // 实时跟踪
 #define TRACKING_MODE_ZOOMING 2     // 缩放变化时跟踪
+#define TRACKING_MODE_ACTIVITY 3    // 自动取景（跟随画面中最活跃的区域）
+#define TRACKING_MODE_EXTERNAL 4    // 位置由调用方设置（回放、脚本时间轴，不在设置中列出）
+
+// 光标预测模型
+#define PREDICT_MODE_NONE 0         // 不预测
+#define PREDICT_MODE_VELOCITY 1     // 恒速外推
+#define PREDICT_MODE_KALMAN 2       // 卡尔曼滤波速度外推
+
+// 等待校验的预测记录数
+#define PREDICT_PENDING_MAX 16
+
+// 光标数据源（桌面坐标，像素），由适配层注入；时间由调用方传入，模块本身不读取时钟
+struct tracking_cursor {
+    bool (*acquire)(void);      // 开始跟踪时调用（例如启动采样线程）
+    void (*release)(void);      // 停止跟踪时调用
+    // 读取当前视频帧的光标位置（可在多个实例间共享缓存）
+    bool (*get_frame)(uint64_t timestamp, float *x, float *y);
+    // 读取插值到指定时间戳的最新光标位置（延迟锁存、预测校验）
+    bool (*get)(uint64_t timestamp, float *x, float *y);
+    // 估计指定时间戳处的光标速度（像素/秒）
+    bool (*get_velocity)(uint64_t timestamp, uint64_t window_ns, float *vx, float *vy);
+};
+
+// 桌面坐标到源内相对坐标（0-1范围）的映射：relative = desktop * scale + offset
+// 捕获区域只在显示器布局变化、源尺寸变化或设置更新时重新解析
+struct tracking_mapping {
+    float scale_x;
+    float scale_y;
+    float offset_x;
+    float offset_y;
+    long generation;        // 解析时的显示器布局代号
+    uint32_t width;         // 解析时的源尺寸
+    uint32_t height;
+    bool valid;
+};
+
+// 单轴恒速模型卡尔曼滤波器（状态：位置、速度）
+struct tracking_kalman {
+    float pos;
+    float vel;
+    float p00, p01, p11;    // 协方差矩阵（对称）
+    bool valid;
+};
+
+// 一次预测的记录，到达预测时间后与实际位置比较
+struct tracking_prediction {
+    uint64_t target_time;   // 预测的目标时间
+    float x;                // 预测位置（像素）
+    float y;
+};
 
 // 鼠标跟踪数据结构
 struct tracking_data {
@@ -15,22 +66,107 @@ struct tracking_data {
     float mouse_x;         // 当前鼠标X位置（0-1范围）
     float mouse_y;         // 当前鼠标Y位置（0-1范围）
     bool smooth_enabled;   // 是否启用位置平滑
-    float smoothness;      // 位置平滑系数（0.1-1.0）
+    float smoothness;      // 位置平滑系数（0.1-1.0），时间常数为 1/(10*smoothness) 秒
+    float dead_zone_x;     // 死区宽度（占可见区域宽度的比例，0表示没有死区）
+    float dead_zone_y;     // 死区高度（占可见区域高度的比例）
+    float settle_threshold; // 剩余距离小于此值（源像素）时停止移动
+    bool settled;          // 已停稳：中心保持不变，直到目标越过阈值
     uint64_t last_update;  // 上次更新时间
+    const struct tracking_cursor *cursor; // 光标数据源
+    bool cursor_acquired;  // 是否持有光标数据源引用
+    struct tracking_mapping mapping;   // 桌面坐标到源坐标的映射
+
+    // 自动取景的焦点（0-1范围），由调用方根据画面活动设置
+    float focus_x;
+    float focus_y;
+    bool focus_valid;
+
+    // 程序指定的中心（0-1范围），优先于光标和画面活动，直到被释放
+    float pan_x;
+    float pan_y;
+    bool pan_active;
+    bool pan_returning;    // 无跟踪模式下释放后正在回到画面中心
+
+    // 预测参数
+    int predict_mode;          // 预测模型
+    uint64_t predict_horizon;  // 预测时长(ns)
+    struct tracking_kalman kf_x;
+    struct tracking_kalman kf_y;
+
+    // 预测误差统计（像素）
+    struct tracking_prediction pending[PREDICT_PENDING_MAX];
+    int pending_head;
+    int pending_count;
+    float predict_error;       // 误差滑动平均
+    float predict_error_max;   // 最大误差
+    uint64_t predict_checked;  // 已校验的预测数
+
+    // 延迟锁存：渲染前重新读取光标时使用的本帧状态
+    bool latch_active;     // 本帧是否跟随了光标
+    float latch_follow;    // 本帧平滑系数，锁存偏移按同样比例跟随
+    float target_x;        // 本帧更新时使用的目标位置（0-1范围）
+    float target_y;
 };
 
-// 初始化跟踪数据
-void tracking_init(struct tracking_data *tracking);
+// 初始化映射（未解析前按源尺寸直接相除）
+void mapping_init(struct tracking_mapping *mapping);
+
+// 标记映射需要重新解析（例如滤镜设置更新后）
+void mapping_invalidate(struct tracking_mapping *mapping);
+
+// 按捕获区域（桌面坐标，像素）设置映射，并记录解析时的布局代号和源尺寸
+void mapping_set_region(struct tracking_mapping *mapping,
+                        float x, float y, float width, float height,
+                        long generation, uint32_t source_width, uint32_t source_height);
+
+// 将桌面坐标映射到源内相对坐标
+static inline void mapping_apply(const struct tracking_mapping *mapping,
+                                 float x, float y, float *rel_x, float *rel_y)
+{
+    *rel_x = x * mapping->scale_x + mapping->offset_x;
+    *rel_y = y * mapping->scale_y + mapping->offset_y;
+}
+
+// 初始化跟踪数据，cursor在跟踪数据的整个生命周期内必须有效
+void tracking_init(struct tracking_data *tracking, const struct tracking_cursor *cursor);
+
+// 释放跟踪数据
+void tracking_free(struct tracking_data *tracking);
+
+// 设置跟踪模式（按需获取/释放光标数据源）
+void tracking_set_mode(struct tracking_data *tracking, int mode);
+
+// 设置自动取景的焦点（源内相对坐标，0-1范围）
+void tracking_set_focus(struct tracking_data *tracking, float x, float y);
+
+// 把中心平滑移动到指定位置（0-1范围）并保持，任一坐标为负数时恢复按跟踪模式移动
+void tracking_pan_to(struct tracking_data *tracking, float x, float y);
+
+// 直接设置跟踪位置（0-1范围），用于回放录制的轨迹和脚本时间轴
+void tracking_set_position(struct tracking_data *tracking, float x, float y);
+
+// 设置预测模型和预测时长(ms)
+void tracking_set_prediction(struct tracking_data *tracking, int mode, int horizon_ms);
 
 // 更新鼠标位置
-void tracking_update_mouse(struct tracking_data *tracking, 
-                         float width, float height, 
+void tracking_update_mouse(struct tracking_data *tracking,
+                         float width, float height,
                          float scale, float last_scale,
                          uint64_t current_time);
 
 // 获取跟踪位置（单位：像素）
-void tracking_get_center(struct tracking_data *tracking,
+void tracking_get_center(const struct tracking_data *tracking,
                         float width, float height,
                         float *center_x, float *center_y);
 
+// 延迟锁存：在构建渲染矩阵前以最新时间重新读取光标，得到本次绘制的跟踪位置（像素）
+void tracking_get_latched_center(const struct tracking_data *tracking,
+                                float width, float height,
+                                uint64_t current_time,
+                                float *center_x, float *center_y);
+
+// 获取预测误差统计（像素），尚无校验数据时返回false
+bool tracking_get_prediction_error(const struct tracking_data *tracking,
+                                  float *mean, float *max);
+
 #endif // ZOOM_TRACKING_H
@@ -0,0 +1,31 @@
+#include "zoom-transform.h"
+
+// 计算可见区域：与矩阵模式相同，中心点在画面中保持不动，
+// 但区域被限制在源范围内，缩放小于1（例如超调）时也不会露出源外的黑边
+void transform_compute_viewport(uint32_t width, uint32_t height,
+                                float scale, float center_x, float center_y,
+                                struct zoom_viewport *viewport)
+{
+    if (scale < 1.0f) {
+        scale = 1.0f;
+    }
+    
+    float view_w = (float)width / scale;
+    float view_h = (float)height / scale;
+    float left = center_x - center_x / scale;
+    float top = center_y - center_y / scale;
+    
+    float max_left = (float)width - view_w;
+    float max_top = (float)height - view_h;
+    viewport->left = left < 0.0f ? 0.0f : (left > max_left ? max_left : left);
+    viewport->top = top < 0.0f ? 0.0f : (top > max_top ? max_top : top);
+    viewport->width = view_w;
+    viewport->height = view_h;
+}
+
+// 缩放为1时无论中心点在哪里都是恒等变换，跟踪位置不影响画面
+bool transform_is_identity(const struct smoothing_data *smoothing)
+{
+    return smoothing->current_scale == 1.0f &&
+           smoothing->transition_start == 0;
+}
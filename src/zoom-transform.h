@@ -0,0 +1,25 @@
+#ifndef ZOOM_TRANSFORM_H
+#define ZOOM_TRANSFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "zoom-smoothing.h"
+
+// 可见区域（源坐标，像素）
+struct zoom_viewport {
+    float left;
+    float top;
+    float width;
+    float height;
+};
+
+// 计算可见区域：中心点在画面中保持不动，区域限制在源范围内，
+// 缩放小于1（例如超调）时按1处理，不会露出源外的黑边
+void transform_compute_viewport(uint32_t width, uint32_t height,
+                                float scale, float center_x, float center_y,
+                                struct zoom_viewport *viewport);
+
+// 当前状态是否为恒等变换（未缩放且没有进行中的过渡）
+bool transform_is_identity(const struct smoothing_data *smoothing);
+
+#endif // ZOOM_TRANSFORM_H
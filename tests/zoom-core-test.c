@@ -0,0 +1,1134 @@
+/*
+ * zoom-core tests: smoothing trajectories, viewport clamping, coordinate
+ * mapping, cursor tracking, programmatic zoom/pan, rate-based hold zoom,
+ * motion detection, trajectory replay and scripted timelines, driven by a
+ * simulated frame clock and a scripted cursor source.
+ *
+ * Usage: zoom-core-test   (exit status is the number of failed checks)
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zoom-motion.h"
+#include "zoom-replay.h"
+#include "zoom-smoothing.h"
+#include "zoom-timeline.h"
+#include "zoom-tracking.h"
+#include "zoom-transform.h"
+
+#define FRAME_NS 16666667ULL
+#define MS(x) ((uint64_t)(x) * 1000000ULL)
+
+static int failures;
+static int checks;
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        checks++;                                                          \
+        if (!(cond)) {                                                     \
+            failures++;                                                    \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                  \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps) CHECK(fabsf((float)(a) - (float)(b)) <= (eps))
+
+// 脚本化的光标数据源
+static struct {
+    float x, y;
+    float vx, vy;
+    bool valid;
+    int acquired;
+    bool unavailable;
+} fake;
+
+static bool fake_acquire(void)
+{
+    if (fake.unavailable)
+        return false;
+    fake.acquired++;
+    return true;
+}
+
+static void fake_release(void)
+{
+    fake.acquired--;
+}
+
+static bool fake_get(uint64_t timestamp, float *x, float *y)
+{
+    (void)timestamp;
+    if (!fake.valid)
+        return false;
+    *x = fake.x;
+    *y = fake.y;
+    return true;
+}
+
+static bool fake_get_velocity(uint64_t timestamp, uint64_t window_ns, float *vx, float *vy)
+{
+    (void)timestamp;
+    (void)window_ns;
+    if (!fake.valid)
+        return false;
+    *vx = fake.vx;
+    *vy = fake.vy;
+    return true;
+}
+
+static const struct tracking_cursor fake_cursor = {
+    .acquire = fake_acquire,
+    .release = fake_release,
+    .get_frame = fake_get,
+    .get = fake_get,
+    .get_velocity = fake_get_velocity,
+};
+
+static void fake_reset(float x, float y)
+{
+    fake.x = x;
+    fake.y = y;
+    fake.vx = 0.0f;
+    fake.vy = 0.0f;
+    fake.valid = true;
+}
+
+// 以固定帧间隔推进，直到过渡结束或超过max_ns，返回结束时间
+static uint64_t run_smoothing(struct smoothing_data *smoothing, uint64_t start,
+                              uint64_t frame_ns, uint64_t max_ns,
+                              bool *monotonic, bool *finite)
+{
+    float last = smoothing->current_scale;
+    float direction = smoothing->target_scale - smoothing->current_scale;
+    uint64_t now = start;
+
+    *monotonic = true;
+    *finite = true;
+
+    // 滤镜在设置目标的同一帧内就会更新一次（进度为0）
+    if (!isfinite(smoothing_update(smoothing, start)))
+        *finite = false;
+
+    while (smoothing->transition_start != 0 && now - start <= max_ns) {
+        now += frame_ns;
+        float scale = smoothing_update(smoothing, now);
+        if (!isfinite(scale))
+            *finite = false;
+        if ((scale - last) * direction < -1e-6f)
+            *monotonic = false;
+        last = scale;
+    }
+    return now;
+}
+
+static void test_curve_trajectories(void)
+{
+    for (int mode = SMOOTH_MODE_LINEAR; mode <= SMOOTH_MODE_LOGARITHMIC; mode++) {
+        struct smoothing_data smoothing;
+        bool monotonic, finite;
+        uint64_t start = MS(1000);
+
+        smoothing_init(&smoothing);
+        smoothing.mode = mode;
+        smoothing_rebuild_curve(&smoothing);
+
+        smoothing_set_target(&smoothing, 3.0f, start);
+        CHECK(smoothing.transition_start == start);
+        CHECK(!smoothing_is_finished(&smoothing, start + MS(100)));
+
+        uint64_t end = run_smoothing(&smoothing, start, FRAME_NS, MS(1000), &monotonic, &finite);
+        CHECK(finite);
+        CHECK(monotonic);
+        CHECK(smoothing.current_scale == 3.0f);
+        CHECK(smoothing.transition_start == 0);
+        // 曲线模式在动画时长结束后的第一帧到达终点
+        CHECK(end - start >= smoothing.animation_time);
+        CHECK(end - start < smoothing.animation_time + FRAME_NS);
+        CHECK(smoothing_is_finished(&smoothing, end));
+
+        // 缩小方向同样单调
+        smoothing_set_target(&smoothing, 1.0f, end);
+        run_smoothing(&smoothing, end, FRAME_NS, MS(1000), &monotonic, &finite);
+        CHECK(finite);
+        CHECK(monotonic);
+        CHECK(smoothing.current_scale == 1.0f);
+    }
+}
+
+// 曲线从本段起点按经过时间计算，不同帧率在同一时刻得到相同的值
+static void test_curve_frame_rate_independent(void)
+{
+    struct smoothing_data a, b;
+    uint64_t start = MS(500);
+
+    smoothing_init(&a);
+    smoothing_init(&b);
+    smoothing_set_target(&a, 2.0f, start);
+    smoothing_set_target(&b, 2.0f, start);
+
+    for (uint64_t t = 0; t <= MS(200); t += MS(5))
+        smoothing_update(&a, start + t);
+    for (uint64_t t = 0; t <= MS(200); t += MS(40))
+        smoothing_update(&b, start + t);
+
+    CHECK(a.current_scale == b.current_scale);
+    CHECK(a.current_scale > 1.0f && a.current_scale < 2.0f);
+}
+
+static void test_spring(void)
+{
+    struct smoothing_data smoothing;
+    bool monotonic, finite;
+    uint64_t start = MS(1000);
+
+    smoothing_init(&smoothing);
+    smoothing.mode = SMOOTH_MODE_SPRING;
+
+    // 静止出发的临界阻尼弹簧不会越过目标
+    smoothing_set_target(&smoothing, 2.5f, start);
+    uint64_t end = run_smoothing(&smoothing, start, FRAME_NS, MS(2000), &monotonic, &finite);
+    CHECK(finite);
+    CHECK(monotonic);
+    CHECK(smoothing.current_scale == 2.5f);
+    CHECK(smoothing.velocity == 0.0f);
+    CHECK(end - start < 2 * smoothing.animation_time);
+
+    // 中途改变目标：位置连续、速度保留
+    smoothing_set_target(&smoothing, 4.0f, end);
+    uint64_t now = end;
+    for (int i = 0; i < 6; i++) {
+        now += FRAME_NS;
+        smoothing_update(&smoothing, now);
+    }
+    float before = smoothing.current_scale;
+    float velocity = smoothing.velocity;
+    CHECK(velocity > 0.0f);
+    smoothing_set_target(&smoothing, 1.0f, now);
+    CHECK(smoothing.current_scale == before);
+    CHECK(smoothing.velocity == velocity);
+    now += FRAME_NS;
+    smoothing_update(&smoothing, now);
+    CHECK(fabsf(smoothing.current_scale - before) < velocity * 0.05f);
+
+    run_smoothing(&smoothing, now, FRAME_NS, MS(4000), &monotonic, &finite);
+    CHECK(finite);
+    CHECK(smoothing.current_scale == 1.0f);
+
+    // 长时间未更新时步长受限，不会一步跳到终点
+    smoothing_set_target(&smoothing, 3.0f, now);
+    smoothing_update(&smoothing, now + MS(10000));
+    CHECK(smoothing.current_scale > 1.0f && smoothing.current_scale < 3.0f);
+}
+
+static void test_smoothing_edge_cases(void)
+{
+    struct smoothing_data smoothing;
+    bool monotonic, finite;
+
+    // 禁用平滑：立即到达
+    smoothing_init(&smoothing);
+    smoothing.enabled = false;
+    smoothing_set_target(&smoothing, 2.0f, MS(10));
+    CHECK(smoothing.current_scale == 2.0f);
+    CHECK(smoothing.transition_start == 0);
+    CHECK(smoothing_is_finished(&smoothing, MS(10)));
+
+    // 动画时长为0：下一次更新直接到达
+    smoothing_init(&smoothing);
+    smoothing.animation_time = 0;
+    smoothing_set_target(&smoothing, 2.0f, MS(10));
+    CHECK(smoothing_update(&smoothing, MS(10)) == 2.0f);
+    CHECK(smoothing.transition_start == 0);
+
+    // 变化小于阈值时不触发过渡
+    smoothing_init(&smoothing);
+    smoothing_set_target(&smoothing, 1.0005f, MS(10));
+    CHECK(smoothing.transition_start == 0);
+
+    // smoothness == 0 / 结束减速为0 / 起始速度为0：各模式都不产生NaN并能到达目标
+    for (int mode = SMOOTH_MODE_LINEAR; mode <= SMOOTH_MODE_SPRING; mode++) {
+        for (int param = 0; param < 3; param++) {
+            smoothing_init(&smoothing);
+            smoothing.mode = mode;
+            if (param == 0)
+                smoothing.smoothness = 0.0f;
+            else if (param == 1)
+                smoothing.end_deceleration = 0.0f;
+            else
+                smoothing.start_speed = 0.0f;
+            CHECK(smoothing_rebuild_curve(&smoothing));
+            CHECK(isfinite(smoothing.curve_error));
+
+            smoothing_set_target(&smoothing, 2.0f, MS(100));
+            run_smoothing(&smoothing, MS(100), FRAME_NS, MS(2000), &monotonic, &finite);
+            CHECK(finite);
+            CHECK(smoothing.current_scale == 2.0f);
+        }
+    }
+
+    // 参数未变化时跳过重建
+    smoothing_init(&smoothing);
+    CHECK(!smoothing_rebuild_curve(&smoothing));
+    smoothing.overshoot = 0.2f;
+    CHECK(smoothing_rebuild_curve(&smoothing));
+    CHECK(smoothing.curve_error < 0.005f);
+
+    // 复制在其他地方建好的设置：曲线与设置一致，进行中的过渡不受影响
+    struct smoothing_data settings;
+    smoothing_init(&settings);
+    settings.mode = SMOOTH_MODE_LOGARITHMIC;
+    settings.animation_time = MS(800);
+    CHECK(smoothing_rebuild_curve(&settings));
+    smoothing_init(&smoothing);
+    smoothing_set_target(&smoothing, 3.0f, MS(100));
+    smoothing_update(&smoothing, MS(200));
+    float mid_scale = smoothing.current_scale;
+    smoothing_copy_settings(&smoothing, &settings);
+    CHECK(smoothing.mode == SMOOTH_MODE_LOGARITHMIC && smoothing.animation_time == MS(800));
+    CHECK(smoothing.current_scale == mid_scale && smoothing.target_scale == 3.0f);
+    CHECK(smoothing.transition_start == MS(100));
+    CHECK(!smoothing_rebuild_curve(&smoothing));
+    CHECK(memcmp(smoothing.curve_lut, settings.curve_lut, sizeof(settings.curve_lut)) == 0);
+}
+
+static void test_viewport(void)
+{
+    struct zoom_viewport vp;
+
+    // 中心点在画面中央
+    transform_compute_viewport(1920, 1080, 2.0f, 960.0f, 540.0f, &vp);
+    CHECK_NEAR(vp.left, 480.0f, 1e-3f);
+    CHECK_NEAR(vp.top, 270.0f, 1e-3f);
+    CHECK_NEAR(vp.width, 960.0f, 1e-3f);
+    CHECK_NEAR(vp.height, 540.0f, 1e-3f);
+
+    // 中心点在画面中保持不动
+    transform_compute_viewport(1920, 1080, 4.0f, 300.0f, 200.0f, &vp);
+    CHECK_NEAR(vp.left + 300.0f / 4.0f, 300.0f, 1e-3f);
+    CHECK_NEAR(vp.top + 200.0f / 4.0f, 200.0f, 1e-3f);
+
+    // 超出源范围的中心点被限制在边缘
+    transform_compute_viewport(1920, 1080, 2.0f, -500.0f, 5000.0f, &vp);
+    CHECK(vp.left == 0.0f);
+    CHECK_NEAR(vp.top, 540.0f, 1e-3f);
+    transform_compute_viewport(1920, 1080, 2.0f, 5000.0f, -500.0f, &vp);
+    CHECK_NEAR(vp.left, 960.0f, 1e-3f);
+    CHECK(vp.top == 0.0f);
+
+    // 缩放小于1（超调）按1处理，不露出源外区域
+    transform_compute_viewport(1920, 1080, 0.8f, 100.0f, 100.0f, &vp);
+    CHECK(vp.left == 0.0f && vp.top == 0.0f);
+    CHECK(vp.width == 1920.0f && vp.height == 1080.0f);
+
+    // 恒等判定
+    struct smoothing_data smoothing;
+    smoothing_init(&smoothing);
+    CHECK(transform_is_identity(&smoothing));
+    smoothing_set_target(&smoothing, 2.0f, MS(10));
+    CHECK(!transform_is_identity(&smoothing));
+}
+
+static void test_mapping(void)
+{
+    struct tracking_mapping mapping;
+    float rx, ry;
+
+    mapping_init(&mapping);
+    CHECK(!mapping.valid);
+
+    // 第二块显示器位于 (1920, 0)，尺寸 2560x1440
+    mapping_set_region(&mapping, 1920.0f, 0.0f, 2560.0f, 1440.0f, 3, 2560, 1440);
+    CHECK(mapping.valid);
+    CHECK(mapping.generation == 3);
+    mapping_apply(&mapping, 1920.0f + 1280.0f, 720.0f, &rx, &ry);
+    CHECK_NEAR(rx, 0.5f, 1e-5f);
+    CHECK_NEAR(ry, 0.5f, 1e-5f);
+    mapping_apply(&mapping, 1920.0f, 0.0f, &rx, &ry);
+    CHECK_NEAR(rx, 0.0f, 1e-5f);
+    CHECK_NEAR(ry, 0.0f, 1e-5f);
+
+    // 空区域不产生无穷大
+    mapping_set_region(&mapping, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0, 0);
+    mapping_apply(&mapping, 100.0f, 100.0f, &rx, &ry);
+    CHECK(isfinite(rx) && isfinite(ry));
+
+    mapping_invalidate(&mapping);
+    CHECK(!mapping.valid);
+}
+
+static void test_tracking(void)
+{
+    struct tracking_data tracking;
+    float cx, cy;
+    uint64_t now = MS(1000);
+
+    fake_reset(480.0f, 270.0f);
+    fake.acquired = 0;
+    tracking_init(&tracking, &fake_cursor);
+
+    // 禁用模式：不获取光标，中心固定在画面中央
+    tracking_set_mode(&tracking, TRACKING_MODE_DISABLED);
+    CHECK(fake.acquired == 0);
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 1.0f, now);
+    tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+    CHECK(cx == 960.0f && cy == 540.0f);
+
+    // 数据源不可用：不持有引用，切回禁用模式时也不释放
+    fake.unavailable = true;
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    CHECK(fake.acquired == 0 && !tracking.cursor_acquired);
+    tracking_set_mode(&tracking, TRACKING_MODE_DISABLED);
+    CHECK(fake.acquired == 0);
+    fake.unavailable = false;
+
+    // 实时模式、不平滑：直接跟随光标
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    CHECK(fake.acquired == 1);
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    CHECK(fake.acquired == 1);
+    tracking.smooth_enabled = false;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK_NEAR(tracking.mouse_x, 0.25f, 1e-5f);
+    CHECK_NEAR(tracking.mouse_y, 0.25f, 1e-5f);
+
+    // 光标超出源范围时限制在0-1
+    fake_reset(5000.0f, -100.0f);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(tracking.mouse_x == 1.0f && tracking.mouse_y == 0.0f);
+
+    // 读取失败时保持原位置
+    fake.valid = false;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(tracking.mouse_x == 1.0f && tracking.mouse_y == 0.0f);
+    CHECK(tracking.last_update == now);
+
+    // 平滑跟随：逐帧逼近，不越过目标
+    fake_reset(960.0f, 540.0f);
+    tracking.smooth_enabled = true;
+    tracking.smoothness = 0.6f;
+    float last = tracking.mouse_x;
+    for (int i = 0; i < 120; i++) {
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+        CHECK(tracking.mouse_x <= last && tracking.mouse_x >= 0.5f);
+        last = tracking.mouse_x;
+    }
+    CHECK_NEAR(tracking.mouse_x, 0.5f, 1e-3f);
+    CHECK_NEAR(tracking.mouse_y, 0.5f, 1e-3f);
+
+    // smoothness == 0：位置保持不动
+    tracking.smoothness = 0.0f;
+    fake_reset(0.0f, 0.0f);
+    float held_x = tracking.mouse_x;
+    for (int i = 0; i < 10; i++) {
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    }
+    CHECK(tracking.mouse_x == held_x);
+    CHECK(isfinite(tracking.mouse_x) && isfinite(tracking.mouse_y));
+
+    // 缩放变化时跟踪：缩放不变时不更新
+    tracking.smooth_enabled = false;
+    tracking_set_mode(&tracking, TRACKING_MODE_ZOOMING);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+    CHECK(tracking.mouse_x == held_x);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.1f, 2.0f, now);
+    CHECK(tracking.mouse_x == 0.0f && tracking.mouse_y == 0.0f);
+
+    // 映射生效时按捕获区域换算
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    mapping_set_region(&tracking.mapping, 1920.0f, 0.0f, 1920.0f, 1080.0f, 0, 1920, 1080);
+    fake_reset(1920.0f + 960.0f, 540.0f);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK_NEAR(tracking.mouse_x, 0.5f, 1e-5f);
+    mapping_init(&tracking.mapping);
+
+    // 恒速预测：位置外推预测时长
+    tracking_set_prediction(&tracking, PREDICT_MODE_VELOCITY, 100);
+    fake_reset(960.0f, 540.0f);
+    fake.vx = 1920.0f;    // 每秒一个画面宽度
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK_NEAR(tracking.mouse_x, 0.6f, 1e-4f);
+    CHECK_NEAR(tracking.mouse_y, 0.5f, 1e-4f);
+
+    // 延迟锁存：光标在更新后又移动，绘制位置跟上最新位置
+    fake.vx = 0.0f;
+    tracking_set_prediction(&tracking, PREDICT_MODE_NONE, 0);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    fake.x = 1440.0f;
+    tracking_get_latched_center(&tracking, 1920.0f, 1080.0f, now + MS(5), &cx, &cy);
+    CHECK_NEAR(cx, 1440.0f, 1e-2f);
+    CHECK_NEAR(cy, 540.0f, 1e-2f);
+    tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+    CHECK_NEAR(cx, 960.0f, 1e-2f);
+
+    // 自动取景：不占用光标，没有焦点时保持原位，之后跟随焦点
+    tracking_set_mode(&tracking, TRACKING_MODE_ACTIVITY);
+    CHECK(fake.acquired == 0);
+    tracking.smooth_enabled = false;
+    held_x = tracking.mouse_x;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(tracking.mouse_x == held_x);
+    tracking_set_focus(&tracking, 0.2f, 1.5f);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK_NEAR(tracking.mouse_x, 0.2f, 1e-6f);
+    CHECK(tracking.mouse_y == 1.0f);
+    tracking.smooth_enabled = true;
+    tracking.smoothness = 0.6f;
+    tracking_set_focus(&tracking, 0.8f, 0.5f);
+    last = tracking.mouse_x;
+    for (int i = 0; i < 120; i++) {
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+        CHECK(tracking.mouse_x >= last && tracking.mouse_x <= 0.8f);
+        last = tracking.mouse_x;
+    }
+    CHECK_NEAR(tracking.mouse_x, 0.8f, 1e-3f);
+    CHECK_NEAR(tracking.mouse_y, 0.5f, 1e-3f);
+
+    tracking_set_mode(&tracking, TRACKING_MODE_DISABLED);
+    CHECK(fake.acquired == 0);
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    tracking_free(&tracking);
+    CHECK(fake.acquired == 0);
+
+    // 没有光标数据源时跟踪不生效
+    tracking_init(&tracking, NULL);
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(tracking.mouse_x == 0.5f && tracking.mouse_y == 0.5f);
+    tracking_free(&tracking);
+}
+
+// 以指定帧率跟随光标从左边缘移到中央，返回经过duration后的位置
+static float pan_after(double fps, uint64_t duration)
+{
+    struct tracking_data tracking;
+    uint64_t frame = (uint64_t)(1e9 / fps);
+    uint64_t now = MS(1000);
+
+    fake_reset(0.0f, 540.0f);
+    tracking_init(&tracking, &fake_cursor);
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    tracking.smooth_enabled = false;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    tracking.smooth_enabled = true;
+    tracking.smoothness = 0.3f;
+
+    fake_reset(960.0f, 540.0f);
+    uint64_t end = now + duration;
+    while (now + frame <= end) {
+        now += frame;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    }
+    float x = tracking.mouse_x;
+    tracking_free(&tracking);
+    return x;
+}
+
+static void test_pan_smoothing(void)
+{
+    struct tracking_data tracking;
+    uint64_t now = MS(1000);
+
+    // 时间常数平滑：30/60/144fps经过相同时间到达同一位置（线性近似下相差约5像素）
+    float x30 = pan_after(30.0, MS(500));
+    float x60 = pan_after(60.0, MS(500));
+    float x144 = pan_after(144.0, MS(500));
+    float expected = 0.5f * (1.0f - expf(-3.0f * 0.5f));
+    CHECK_NEAR(x60, expected, 2e-3f);
+    CHECK_NEAR(x30, x60, 2e-3f);
+    CHECK_NEAR(x144, x60, 2e-3f);
+
+    fake_reset(960.0f, 540.0f);
+    tracking_init(&tracking, &fake_cursor);
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    tracking.smooth_enabled = false;
+
+    // 死区（可见区域的20%）：范围内移动不平移，越出时目标停在死区边上
+    tracking.dead_zone_x = 0.2f;
+    tracking.dead_zone_y = 0.2f;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(tracking.mouse_x == 0.5f && tracking.mouse_y == 0.5f);
+    fake.x = 960.0f + 150.0f;           // 死区半宽192像素以内
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(tracking.mouse_x == 0.5f);
+    fake.x = 960.0f + 300.0f;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK_NEAR(tracking.mouse_x * 1920.0f, 960.0f + 300.0f - 192.0f, 1e-2f);
+    CHECK(tracking.mouse_y == 0.5f);
+
+    // 放大2倍后死区在源内减半
+    fake.x = tracking.mouse_x * 1920.0f + 150.0f;
+    float before = tracking.mouse_x;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+    CHECK_NEAR((tracking.mouse_x - before) * 1920.0f, 150.0f - 96.0f, 1e-2f);
+
+    // 停稳：亚像素抖动下中心逐位相同，也不做延迟锁存
+    tracking.dead_zone_x = 0.0f;
+    tracking.dead_zone_y = 0.0f;
+    tracking.smooth_enabled = true;
+    tracking.smoothness = 0.6f;
+    tracking.settle_threshold = 0.5f;
+    fake_reset(700.0f, 400.0f);
+    for (int i = 0; i < 600; i++) {
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    }
+    CHECK(tracking.settled);
+    CHECK(!tracking.latch_active);
+    CHECK(tracking.mouse_x == 700.0f / 1920.0f && tracking.mouse_y == 400.0f / 1080.0f);
+    float held_x = tracking.mouse_x, held_y = tracking.mouse_y;
+    bool identical = true;
+    for (int i = 0; i < 100; i++) {
+        fake.x = 700.0f + ((i % 2) ? 0.3f : -0.3f);
+        fake.y = 400.0f + ((i % 3) ? 0.2f : -0.4f);
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+        if (tracking.mouse_x != held_x || tracking.mouse_y != held_y || tracking.latch_active)
+            identical = false;
+    }
+    CHECK(identical);
+
+    // 越过阈值后重新开始跟随
+    fake.x = 720.0f;
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    CHECK(!tracking.settled && tracking.latch_active);
+    CHECK(tracking.mouse_x > held_x);
+    tracking_free(&tracking);
+}
+
+static void test_programmatic_control(void)
+{
+    struct smoothing_data smoothing;
+    struct tracking_data tracking;
+    bool monotonic, finite;
+    uint64_t now = MS(1000);
+
+    // 指定时长的过渡：不受设置中的动画时长和平滑开关影响
+    for (int mode = SMOOTH_MODE_LINEAR; mode <= SMOOTH_MODE_LOGARITHMIC; mode++) {
+        smoothing_init(&smoothing);
+        smoothing.mode = mode;
+        smoothing_rebuild_curve(&smoothing);
+        smoothing.enabled = false;
+        smoothing_set_target_timed(&smoothing, 3.0f, now, MS(1000));
+        uint64_t end = run_smoothing(&smoothing, now, FRAME_NS, MS(3000), &monotonic, &finite);
+        CHECK(monotonic && finite);
+        CHECK(smoothing.current_scale == 3.0f);
+        CHECK(end - now >= MS(1000) && end - now < MS(1000) + FRAME_NS);
+        CHECK(smoothing.transition_time == 0);
+    }
+
+    // 结束后恢复使用设置：平滑关闭时的普通目标立即到达
+    smoothing_set_target(&smoothing, 1.0f, now);
+    CHECK(smoothing.current_scale == 1.0f);
+
+    // 时长为0：立即到达
+    smoothing_init(&smoothing);
+    smoothing_set_target_timed(&smoothing, 2.0f, now, 0);
+    CHECK(smoothing.current_scale == 2.0f && smoothing.transition_start == 0);
+
+    // 弹簧模式按指定时长收敛
+    smoothing_init(&smoothing);
+    smoothing.mode = SMOOTH_MODE_SPRING;
+    smoothing_set_target_timed(&smoothing, 2.0f, now, MS(100));
+    uint64_t end = run_smoothing(&smoothing, now, FRAME_NS, MS(2000), &monotonic, &finite);
+    CHECK(finite && smoothing.current_scale == 2.0f);
+    CHECK(end - now < MS(300));
+
+    // 程序指定中心：不读取光标，平滑移动到指定位置并保持
+    fake_reset(100.0f, 100.0f);
+    tracking_init(&tracking, &fake_cursor);
+    tracking_set_mode(&tracking, TRACKING_MODE_REALTIME);
+    tracking.smooth_enabled = true;
+    tracking.smoothness = 0.6f;
+    tracking.settle_threshold = 0.5f;
+    tracking_pan_to(&tracking, 0.75f, 0.25f);
+    for (int i = 0; i < 300; i++) {
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+    }
+    CHECK(tracking.mouse_x == 0.75f && tracking.mouse_y == 0.25f);
+    CHECK(!tracking.latch_active);
+
+    // 负坐标恢复跟随光标
+    tracking_pan_to(&tracking, -1.0f, -1.0f);
+    CHECK(!tracking.pan_active);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+    CHECK(tracking.mouse_x < 0.75f);
+    tracking_free(&tracking);
+
+    // 无跟踪模式：从画面中心开始平移（不受死区影响），释放后平滑回到中心
+    tracking_init(&tracking, &fake_cursor);
+    tracking.mouse_x = 0.1f;
+    tracking.smooth_enabled = false;
+    tracking.dead_zone_x = 0.5f;
+    tracking_pan_to(&tracking, 0.6f, 0.5f);
+    CHECK(tracking.mouse_x == 0.5f);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, now);
+    float cx, cy;
+    tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+    CHECK_NEAR(cx, 0.6f * 1920.0f, 1e-2f);
+
+    tracking.smooth_enabled = true;
+    tracking.smoothness = 0.6f;
+    tracking_pan_to(&tracking, -1.0f, 0.0f);
+    tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+    CHECK_NEAR(cx, 0.6f * 1920.0f, 1e-2f);
+    bool eased = true;
+    float last_cx = cx;
+    int frames = 0;
+    while (tracking.pan_returning && frames < 600) {
+        now += FRAME_NS;
+        tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+        tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+        if (cx > last_cx || last_cx - cx > 0.2f * 1920.0f * 0.1f)
+            eased = false;
+        last_cx = cx;
+        frames++;
+    }
+    CHECK(eased && frames > 10);
+    CHECK(!tracking.pan_returning);
+    tracking_get_center(&tracking, 1920.0f, 1080.0f, &cx, &cy);
+    CHECK(cx == 960.0f && cy == 540.0f);
+
+    // 回到中心途中再次平移：从当前位置开始，不先跳回中心
+    tracking_pan_to(&tracking, 0.8f, 0.5f);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+    tracking_pan_to(&tracking, -1.0f, -1.0f);
+    now += FRAME_NS;
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 2.0f, 2.0f, now);
+    float returning_x = tracking.mouse_x;
+    CHECK(returning_x > 0.5f);
+    tracking_pan_to(&tracking, 0.8f, 0.5f);
+    CHECK(tracking.mouse_x == returning_x && !tracking.pan_returning);
+    tracking_free(&tracking);
+}
+
+static void test_motion(void)
+{
+    enum { W = 64, H = 36, COLS = 16, ROWS = 9 };
+    static uint8_t a[1031], b[1031];
+    static uint8_t cur[W * H * 4], prev[W * H * 4];
+    uint64_t energy[COLS * ROWS], expected[COLS * ROWS];
+    float fx, fy;
+
+    // 各实现与标量实现逐字节一致（含未对齐的起点和不足一个向量的尾部）
+    srand(1234);
+    for (size_t i = 0; i < sizeof(a); i++) {
+        a[i] = (uint8_t)rand();
+        b[i] = (uint8_t)rand();
+    }
+    CHECK(motion_kernel_supported(MOTION_KERNEL_SCALAR));
+    CHECK(motion_kernel_supported(motion_best_kernel()));
+    for (int kernel = MOTION_KERNEL_SCALAR; kernel <= MOTION_KERNEL_AVX2; kernel++) {
+        if (!motion_kernel_supported(kernel))
+            continue;
+        for (size_t offset = 0; offset < 4; offset++) {
+            for (size_t size = 0; size + offset <= sizeof(a); size += 37) {
+                CHECK(motion_sad(kernel, a + offset, b + offset, size) ==
+                      motion_sad(MOTION_KERNEL_SCALAR, a + offset, b + offset, size));
+            }
+        }
+    }
+    CHECK(motion_sad(MOTION_KERNEL_SCALAR, a, a, sizeof(a)) == 0);
+
+    // 静止画面：没有能量，找不到焦点
+    memset(cur, 40, sizeof(cur));
+    memcpy(prev, cur, sizeof(prev));
+    motion_tile_energy(MOTION_KERNEL_SCALAR, cur, prev, W, H, W * 4, COLS, ROWS, energy);
+    for (int i = 0; i < COLS * ROWS; i++)
+        CHECK(energy[i] == 0);
+    CHECK(!motion_find_focus(energy, COLS, ROWS, 1, &fx, &fy));
+
+    // 右下区域变化：焦点落在该区域中心
+    for (int y = 24; y < 32; y++)
+        for (int x = 48; x < 56; x++)
+            memset(cur + ((size_t)y * W + x) * 4, 200, 4);
+    motion_tile_energy(MOTION_KERNEL_SCALAR, cur, prev, W, H, W * 4, COLS, ROWS, expected);
+    CHECK(expected[6 * COLS + 12] == 4ULL * 4 * 4 * 160);
+    CHECK(expected[0] == 0);
+    CHECK(motion_find_focus(expected, COLS, ROWS, 1, &fx, &fy));
+    CHECK_NEAR(fx, 52.0f / W, 1e-3f);
+    CHECK_NEAR(fy, 28.0f / H, 0.02f);
+
+    // 能量低于阈值时视为噪声
+    CHECK(!motion_find_focus(expected, COLS, ROWS, expected[6 * COLS + 12] + 1, &fx, &fy));
+
+    for (int kernel = MOTION_KERNEL_SSE2; kernel <= MOTION_KERNEL_AVX2; kernel++) {
+        if (!motion_kernel_supported(kernel))
+            continue;
+        motion_tile_energy(kernel, cur, prev, W, H, W * 4, COLS, ROWS, energy);
+        CHECK(memcmp(energy, expected, sizeof(energy)) == 0);
+    }
+}
+
+static void test_replay(void)
+{
+    enum { FRAMES = 100 };
+    static struct {
+        struct zoom_log_header header;
+        struct zoom_log_record records[FRAMES];
+    } log;
+    struct replay_data replay;
+    const struct zoom_log_record *record;
+    uint64_t base = MS(5000);
+
+    // 录制第40-49帧时发生了丢帧：时间戳跳过10帧
+    zoom_log_header_init(&log.header, FRAME_NS, base);
+    for (int i = 0; i < FRAMES; i++) {
+        uint64_t frame = (uint64_t)i + (i >= 50 ? 10 : 0);
+        log.records[i].frame_ts = base + frame * FRAME_NS;
+        log.records[i].scale = 1.0f + (float)i * 0.01f;
+        log.records[i].center_x = (float)i / FRAMES;
+        log.records[i].center_y = 0.5f;
+        log.records[i].events = i == 3 ? ZOOM_LOG_EVENT_IN_DOWN : 0;
+    }
+
+    // 格式检查
+    CHECK(!replay_attach(&replay, NULL, 0));
+    CHECK(!replay_attach(&replay, &log, sizeof(log.header)));
+    log.header.version++;
+    CHECK(!replay_attach(&replay, &log, sizeof(log)));
+    log.header.version--;
+    log.header.magic[0] = 'X';
+    CHECK(!replay_attach(&replay, &log, sizeof(log)));
+    log.header.magic[0] = 'Z';
+
+    // 末尾不完整的记录被忽略
+    CHECK(replay_attach(&replay, &log, sizeof(log) - 5));
+    CHECK(replay.count == FRAMES - 1);
+    CHECK(replay_attach(&replay, &log, sizeof(log)));
+    CHECK(replay.count == FRAMES && replay.frame_interval == FRAME_NS);
+
+    // 以不同的时间基准回放，逐帧得到对应的记录
+    uint64_t now = MS(90000);
+    replay_start(&replay, now);
+    for (int i = 0; i < 50; i++) {
+        record = replay_lookup(&replay, now + (uint64_t)i * FRAME_NS);
+        CHECK(record == &log.records[i]);
+    }
+    CHECK(log.records[3].events == ZOOM_LOG_EVENT_IN_DOWN);
+
+    // 丢帧的间隙中保持最后一条记录
+    record = replay_lookup(&replay, now + 55 * FRAME_NS);
+    CHECK(record == &log.records[49]);
+    record = replay_lookup(&replay, now + 60 * FRAME_NS);
+    CHECK(record == &log.records[50]);
+
+    // 帧中间的时间取不晚于它的记录
+    record = replay_lookup(&replay, now + 61 * FRAME_NS + FRAME_NS / 2);
+    CHECK(record == &log.records[51]);
+
+    // 时间倒退和大幅前跳
+    record = replay_lookup(&replay, now + 10 * FRAME_NS);
+    CHECK(record == &log.records[10]);
+    record = replay_lookup(&replay, now + 90 * FRAME_NS);
+    CHECK(record == &log.records[80]);
+    CHECK(!replay_finished(&replay));
+
+    // 超过最后一条后保持最后一条
+    record = replay_lookup(&replay, now + 1000 * FRAME_NS);
+    CHECK(record == &log.records[FRAMES - 1]);
+    CHECK(replay_finished(&replay));
+
+    // 尚未开始时以第一次查找的时间为起点
+    replay_attach(&replay, &log, sizeof(log));
+    record = replay_lookup(&replay, MS(123));
+    CHECK(record == &log.records[0] && replay.start == MS(123));
+
+    // 回放驱动平滑和跟踪：直接跳到录制的值
+    struct smoothing_data smoothing;
+    struct tracking_data tracking;
+    smoothing_init(&smoothing);
+    smoothing_set_target(&smoothing, 3.0f, MS(1));
+    smoothing_update(&smoothing, MS(100));
+    smoothing_jump_to(&smoothing, log.records[20].scale);
+    CHECK(smoothing.current_scale == log.records[20].scale);
+    CHECK(smoothing.target_scale == log.records[20].scale);
+    CHECK(smoothing_update(&smoothing, MS(200)) == log.records[20].scale);
+    CHECK(smoothing_is_finished(&smoothing, MS(200)));
+
+    tracking_init(&tracking, &fake_cursor);
+    tracking_set_mode(&tracking, TRACKING_MODE_EXTERNAL);
+    CHECK(fake.acquired == 0);
+    tracking_set_position(&tracking, 0.3f, 2.0f);
+    tracking_update_mouse(&tracking, 1920.0f, 1080.0f, 1.0f, 1.0f, MS(300));
+    float cx, cy;
+    tracking_get_center(&tracking, 1.0f, 1.0f, &cx, &cy);
+    CHECK_NEAR(cx, 0.3f, 1e-6f);
+    CHECK(cy == 1.0f);
+    tracking_free(&tracking);
+}
+
+static struct timeline_key make_key(double seconds, double duration_ms, float scale)
+{
+    struct timeline_key key = {0};
+    key.time = (uint64_t)(seconds * 1e9);
+    key.duration = (uint64_t)(duration_ms * 1e6);
+    key.scale = scale;
+    key.has_scale = true;
+    return key;
+}
+
+static void test_timeline(void)
+{
+    struct timeline_data timeline;
+    struct timeline_key keys[8];
+    float scale, x, y;
+    uint64_t t;
+
+    // 时间文本
+    CHECK(timeline_parse_time("12", &t) && t == MS(12000));
+    CHECK(timeline_parse_time("00:12", &t) && t == MS(12000));
+    CHECK(timeline_parse_time("01:02.5", &t) && t == MS(62500));
+    CHECK(timeline_parse_time("1:00:00", &t) && t == MS(3600000));
+    CHECK(timeline_parse_time("0.25", &t) && t == MS(250));
+    CHECK(!timeline_parse_time("", &t));
+    CHECK(!timeline_parse_time("1:60", &t));
+    CHECK(!timeline_parse_time("1.5:00", &t));
+    CHECK(!timeline_parse_time("-3", &t));
+    CHECK(!timeline_parse_time("1:2:3:4", &t));
+    CHECK(!timeline_parse_time("12s", &t));
+
+    CHECK(!timeline_compile(&timeline, keys, 0));
+
+    // "00:12 放大到2.5倍，中心(0.3, 0.7)，600ms"：之前保持初始状态，之后保持目标
+    keys[0] = make_key(12.0, 600.0, 2.5f);
+    keys[0].x = 0.3f;
+    keys[0].y = 0.7f;
+    keys[0].has_center = true;
+    CHECK(timeline_compile(&timeline, keys, 1));
+    CHECK(timeline.has_center);
+    timeline_evaluate(&timeline, MS(11999), &scale, &x, &y);
+    CHECK(scale == 1.0f && x == 0.5f && y == 0.5f);
+    timeline_evaluate(&timeline, MS(12000), &scale, &x, &y);
+    CHECK_NEAR(scale, 1.0f, 1e-6f);
+    timeline_evaluate(&timeline, MS(12300), &scale, &x, &y);
+    CHECK_NEAR(scale, 1.75f, 1e-4f);    // 两端速度为0的三次曲线在中点取平均值
+    CHECK_NEAR(x, 0.4f, 1e-4f);
+    CHECK_NEAR(y, 0.6f, 1e-4f);
+    CHECK(!timeline_finished(&timeline, MS(12599)));
+    timeline_evaluate(&timeline, MS(12600), &scale, &x, &y);
+    CHECK(scale == 2.5f && x == 0.3f && y == 0.7f);
+    CHECK(timeline_finished(&timeline, MS(12600)));
+    timeline_free(&timeline);
+    CHECK(timeline.segments == NULL && timeline.count == 0);
+
+    // 乱序输入按时间排序，时间相同的保持原顺序（后写的生效）；只改中心时缩放保持
+    keys[0] = make_key(5.0, 0.0, 3.0f);
+    keys[1] = make_key(1.0, 0.0, 2.0f);
+    keys[2] = make_key(5.0, 0.0, 4.0f);
+    keys[3] = make_key(8.0, 0.0, 0.0f);
+    keys[3].has_scale = false;
+    keys[3].x = 1.5f;
+    keys[3].y = 0.1f;
+    keys[3].has_center = true;
+    CHECK(timeline_compile(&timeline, keys, 4));
+    timeline_evaluate(&timeline, MS(2000), &scale, &x, &y);
+    CHECK(scale == 2.0f && x == 0.5f);
+    timeline_evaluate(&timeline, MS(6000), &scale, &x, &y);
+    CHECK(scale == 4.0f);
+    timeline_evaluate(&timeline, MS(9000), &scale, &x, &y);
+    CHECK(scale == 4.0f && x == 1.0f && y == 0.1f);
+    timeline_free(&timeline);
+
+    // 重叠的过渡在下一个关键帧开始时完成
+    keys[0] = make_key(1.0, 1000.0, 3.0f);
+    keys[1] = make_key(1.5, 500.0, 1.0f);
+    CHECK(timeline_compile(&timeline, keys, 2));
+    CHECK(!timeline.has_center);
+    timeline_evaluate(&timeline, MS(1500), &scale, &x, &y);
+    CHECK_NEAR(scale, 3.0f, 1e-5f);
+    timeline_free(&timeline);
+
+    // 首尾相接的过渡：衔接处速度连续，同方向时不越过目标，反方向时在转折处停住
+    keys[0] = make_key(0.0, 1000.0, 2.0f);
+    keys[1] = make_key(1.0, 1000.0, 4.0f);
+    keys[2] = make_key(2.0, 500.0, 1.0f);
+    CHECK(timeline_compile(&timeline, keys, 3));
+    float last = 0.0f;
+    bool monotonic = true, bounded = true;
+    for (uint64_t ms = 0; ms <= 2500; ms += 5) {
+        timeline_evaluate(&timeline, MS(ms), &scale, &x, &y);
+        if (ms <= 2000 && scale < last - 1e-5f)
+            monotonic = false;
+        if (scale < 1.0f - 1e-5f || scale > 4.0f + 1e-5f)
+            bounded = false;
+        last = scale;
+    }
+    CHECK(monotonic);
+    CHECK(bounded);
+    float before, after, at;
+    timeline_evaluate(&timeline, MS(999), &before, &x, &y);
+    timeline_evaluate(&timeline, MS(1000), &at, &x, &y);
+    timeline_evaluate(&timeline, MS(1001), &after, &x, &y);
+    CHECK_NEAR(at, 2.0f, 1e-5f);
+    CHECK(at - before > 1e-4f);                         // 衔接处没有停顿
+    CHECK_NEAR(at - before, after - at, 1e-4f);         // 速度连续
+    timeline_evaluate(&timeline, MS(1999), &before, &x, &y);
+    timeline_evaluate(&timeline, MS(2000), &at, &x, &y);
+    CHECK_NEAR(at, 4.0f, 1e-5f);
+    CHECK(at - before < 1e-4f);                         // 转折处速度为0
+    timeline_free(&timeline);
+
+    // 数千个关键帧：顺序播放（游标）与随机访问（二分查找）结果一致
+    enum { MANY = 5000 };
+    static struct timeline_key many[MANY];
+    for (int i = 0; i < MANY; i++)
+        many[i] = make_key((double)i * 0.5, (i % 3) * 200.0, 1.0f + (float)(i % 7) * 0.5f);
+    CHECK(timeline_compile(&timeline, many, MANY));
+    struct timeline_data random_access = timeline;
+    bool same = true;
+    for (uint64_t ms = 0; ms < MANY * 500ULL + 1000; ms += 16) {
+        float s1, s2;
+        timeline_evaluate(&timeline, MS(ms), &s1, &x, &y);
+        random_access.cursor = 0;
+        timeline_evaluate(&random_access, MS(ms), &s2, &x, &y);
+        if (s1 != s2)
+            same = false;
+    }
+    CHECK(same);
+    // 倒退后仍然正确
+    timeline_evaluate(&timeline, MS(1000), &scale, &x, &y);
+    CHECK(timeline.cursor == 2);
+    timeline_free(&timeline);
+}
+
+// 按速度积分hold_ns，返回是否每步都没有变小
+static bool run_rate(struct smoothing_data *smoothing, int direction, uint64_t start,
+                     uint64_t step, uint64_t hold_ns)
+{
+    bool monotonic = true;
+
+    smoothing_update_rate(smoothing, direction, 1.0f, 5.0f, start);
+    for (uint64_t t = step; t <= hold_ns; t += step) {
+        float before = smoothing->current_scale;
+        smoothing_update_rate(smoothing, direction, 1.0f, 5.0f, start + t);
+        if ((direction > 0 && smoothing->current_scale < before) ||
+            (direction < 0 && smoothing->current_scale > before))
+            monotonic = false;
+    }
+    return monotonic;
+}
+
+static void test_rate_zoom(void)
+{
+    struct smoothing_data smoothing, other;
+    uint64_t now = MS(1000);
+
+    // 线性速度、立即达到最大速度：按住1秒放大1倍
+    smoothing_init(&smoothing);
+    smoothing.rate_relative = false;
+    smoothing.rate_ramp = 0;
+    CHECK(run_rate(&smoothing, 1, now, FRAME_NS, MS(1000) - MS(1000) % FRAME_NS));
+    CHECK_NEAR(smoothing.current_scale, 1.0f + (float)(MS(1000) - MS(1000) % FRAME_NS) / 1e9f, 1e-4f);
+    CHECK(smoothing.target_scale == smoothing.current_scale);
+
+    // 加速阶段的位移与帧率无关：250ms线性加速后匀速，1秒共0.875
+    smoothing_init(&smoothing);
+    smoothing.rate_relative = false;
+    other = smoothing;
+    run_rate(&smoothing, 1, now, MS(10), MS(1000));
+    run_rate(&other, 1, now, MS(4), MS(1000));
+    CHECK_NEAR(smoothing.current_scale, 1.875f, 1e-4f);
+    CHECK_NEAR(other.current_scale, 1.875f, 1e-4f);
+
+    // 按比例：同样的按住时间在任何缩放值下放大相同的倍数
+    smoothing_init(&smoothing);
+    smoothing.rate = logf(2.0f);
+    smoothing.rate_ramp = 0;
+    other = smoothing;
+    other.current_scale = other.target_scale = 2.0f;
+    run_rate(&smoothing, 1, now, MS(10), MS(1000));
+    run_rate(&other, 1, now, MS(10), MS(1000));
+    CHECK_NEAR(smoothing.current_scale, 2.0f, 1e-3f);
+    CHECK_NEAR(other.current_scale, 4.0f, 2e-3f);
+
+    // 缩小同样按比例，并限制在范围内
+    CHECK(run_rate(&other, -1, now, MS(10), MS(3000)));
+    CHECK(other.current_scale == 1.0f);
+    CHECK(!smoothing_update_rate(&other, -1, 1.0f, 5.0f, now + MS(3010)));
+
+    // 松开后停止，再次按下从静止开始加速
+    smoothing_init(&smoothing);
+    run_rate(&smoothing, 1, now, MS(10), MS(500));
+    CHECK(smoothing.rate_velocity == smoothing.rate);
+    CHECK(!smoothing_update_rate(&smoothing, 0, 1.0f, 5.0f, now + MS(510)));
+    CHECK(smoothing.rate_velocity == 0.0f && smoothing.rate_time == 0);
+    float held = smoothing.current_scale;
+    CHECK(!smoothing_update_rate(&smoothing, 1, 1.0f, 5.0f, now + MS(600)));
+    CHECK(smoothing.current_scale == held);
+
+    // 反向：先减速，速度连续变化
+    run_rate(&smoothing, 1, now + MS(600), MS(10), MS(500));
+    smoothing_update_rate(&smoothing, -1, 1.0f, 5.0f, now + MS(1110));
+    CHECK(smoothing.rate_velocity > 0.0f && smoothing.rate_velocity < smoothing.rate);
+
+    // 连续缩放结束进行中的过渡，从当前画面开始
+    smoothing_init(&smoothing);
+    smoothing_set_target(&smoothing, 3.0f, now);
+    smoothing_update(&smoothing, now + MS(100));
+    float drawn = smoothing.current_scale;
+    run_rate(&smoothing, 1, now + MS(100), MS(10), MS(10));
+    CHECK(smoothing.transition_start == 0);
+    CHECK(smoothing.current_scale >= drawn && smoothing.current_scale < drawn + 0.01f);
+
+    // 按住期间应用新设置：速度和积分时间保留，从当前速度加速到新的最大速度
+    struct smoothing_data settings;
+    smoothing_init(&smoothing);
+    smoothing.rate_relative = false;
+    run_rate(&smoothing, 1, now, MS(10), MS(500));
+    CHECK(smoothing.rate_velocity == 1.0f);
+    uint64_t rate_time = smoothing.rate_time;
+    smoothing_init(&settings);
+    settings.rate = 2.0f;
+    settings.rate_relative = false;
+    settings.rate_ramp = MS(500);
+    smoothing_copy_settings(&smoothing, &settings);
+    CHECK(smoothing.rate == 2.0f && smoothing.rate_ramp == MS(500));
+    CHECK(smoothing.rate_velocity == 1.0f && smoothing.rate_time == rate_time);
+    held = smoothing.current_scale;
+    smoothing_update_rate(&smoothing, 1, 1.0f, 5.0f, rate_time + MS(10));
+    CHECK_NEAR(smoothing.rate_velocity, 1.04f, 1e-4f);
+    CHECK_NEAR(smoothing.current_scale, held + 0.0102f, 1e-4f);
+}
+
+int main(void)
+{
+    test_curve_trajectories();
+    test_curve_frame_rate_independent();
+    test_spring();
+    test_smoothing_edge_cases();
+    test_viewport();
+    test_mapping();
+    test_tracking();
+    test_pan_smoothing();
+    test_programmatic_control();
+    test_rate_zoom();
+    test_motion();
+    test_replay();
+    test_timeline();
+
+    printf("%d checks, %d failed\n", checks, failures);
+    return failures;
+}